@@ -33,8 +33,8 @@ async function register_username() {
     let transaction = new web3.Transaction();
 
     // fund the account
-    const PUBKEY_BYTE_COUNT = 32;
-    const lamports = await connection.getMinimumBalanceForRentExemption(PUBKEY_BYTE_COUNT);
+    const REGISTRATION_BYTE_COUNT = 33; // pubkey and bump seed
+    const lamports = await connection.getMinimumBalanceForRentExemption(REGISTRATION_BYTE_COUNT);
     transaction.add(web3.SystemProgram.transfer({fromPubkey: payer.publicKey, lamports: lamports, toPubkey: pda}));
 
     transaction.add(new web3.TransactionInstruction({
@@ -0,0 +1,32 @@
+/**
+ * Runs the account_logger_example natively and reports its compute units
+ *
+ * Usage: account_logger_example_bench [iterations] [-v]
+ */
+
+#include <sol_host.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" unsigned long entrypoint(const unsigned char* input);
+
+int main(int argc, char** argv) {
+    const uint64_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    sol::host::context().echo_logs = argc > 2 && std::strcmp(argv[2], "-v") == 0;
+
+    const uint8_t program_id[32] = {1};
+    const uint8_t payer[32] = {2};
+    const uint8_t storage[32] = {3};
+    const uint8_t data[40] = {4, 5, 6, 7, 8, 9};
+
+    sol::host::InputBuilder input;
+    input.program_id(program_id);
+    input.account(payer).signer().writable().set_lamports(1000000000);
+    input.account(storage).writable().set_lamports(1000000).set_owner(program_id).set_data(data, sizeof(data));
+    input.duplicate(0);
+
+    sol::host::report("account_logger_example", sol::host::benchmark(entrypoint, input, iterations));
+    return 0;
+}
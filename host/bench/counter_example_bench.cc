@@ -0,0 +1,53 @@
+/**
+ * Runs both instructions of the counter_example natively and reports their compute units
+ *
+ * Usage: counter_example_bench [iterations] [-v]
+ */
+
+#include <sol_host.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" unsigned long entrypoint(const unsigned char* input);
+
+int main(int argc, char** argv) {
+    const uint64_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    sol::host::context().echo_logs = argc > 2 && std::strcmp(argv[2], "-v") == 0;
+
+    const uint8_t program_id[32] = {1};
+    const uint8_t authority[32] = {2};
+    const uint8_t counter[32] = {3};
+
+    // discriminator, authority and count of an initialized counter
+    uint8_t discriminator[32];
+    sol::host::sha256({{"account:Counter", 15}}, discriminator);
+    uint8_t counter_data[48] = {};
+    std::memcpy(counter_data, discriminator, 8);
+    std::memcpy(counter_data + 8, authority, 32);
+    counter_data[40] = 41;
+    const uint8_t unused_data[sizeof(counter_data)] = {};
+
+    const uint8_t initialize[] = {0};
+    sol::host::InputBuilder initialize_input;
+    initialize_input.program_id(program_id);
+    initialize_input.account(authority).signer();
+    initialize_input.account(counter).writable().set_lamports(1000000).set_owner(program_id).set_data(
+        unused_data, sizeof(unused_data)
+    );
+    initialize_input.instruction_data(initialize, sizeof(initialize));
+
+    const uint8_t increment[] = {1, 1, 0, 0, 0, 0, 0, 0, 0};
+    sol::host::InputBuilder increment_input;
+    increment_input.program_id(program_id);
+    increment_input.account(authority).signer();
+    increment_input.account(counter).writable().set_lamports(1000000).set_owner(program_id).set_data(
+        counter_data, sizeof(counter_data)
+    );
+    increment_input.instruction_data(increment, sizeof(increment));
+
+    sol::host::report("counter_example initialize", sol::host::benchmark(entrypoint, initialize_input, iterations));
+    sol::host::report("counter_example increment", sol::host::benchmark(entrypoint, increment_input, iterations));
+    return 0;
+}
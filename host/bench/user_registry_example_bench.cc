@@ -0,0 +1,62 @@
+/**
+ * Runs the user_registry_example natively and reports its compute units
+ *
+ * Usage: user_registry_example_bench [iterations] [-v]
+ */
+
+#include <sol_host.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" unsigned long entrypoint(const unsigned char* input);
+
+int main(int argc, char** argv) {
+    const uint64_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    sol::host::context().echo_logs = argc > 2 && std::strcmp(argv[2], "-v") == 0;
+
+    const uint8_t program_id[32] = {1};
+    const uint8_t user[32] = {2};
+    const uint8_t system_program[32] = {};
+    const uint8_t memo_program[32] = {
+        0x05, 0x4a, 0x53, 0x5a, 0x99, 0x29, 0x21, 0x06, 0x4d, 0x24, 0xe8, 0x71, 0x60, 0xda, 0x38, 0x7c,
+        0x7c, 0x35, 0xb5, 0xdd, 0xbc, 0x92, 0xbb, 0x81, 0xe4, 0x1f, 0xa8, 0x40, 0x41, 0x05, 0x44, 0x8d,
+    };
+    const char username[] = "myname";
+
+    uint8_t pda[32];
+    uint8_t bump_seed;
+    if (!sol::host::find_program_address({{username, sizeof(username) - 1}}, program_id, pda, &bump_seed)) {
+        std::fprintf(stderr, "no program address found\n");
+        return 1;
+    }
+
+    sol::host::InputBuilder input;
+    input.program_id(program_id);
+    input.account(user).signer();
+    input.account(pda).writable().set_lamports(1000000000).set_owner(system_program);
+    input.account(system_program).set_executable();
+    input.account(memo_program).set_executable();
+    input.instruction_data(username, sizeof(username) - 1);
+
+    // like the runtime, fail invocations that don't pass all accounts of the instruction
+    sol::host::context().invoke = [](const sol::host::RawInstruction& instruction,
+                                     const sol::host::RawAccountInfo* account_infos, uint64_t account_infos_len,
+                                     const sol::host::RawSeeds*, uint64_t) -> uint64_t {
+        for (uint64_t i = 0; i != instruction.accounts_len + 1; ++i) {
+            const uint8_t* key = i < instruction.accounts_len ? instruction.accounts[i].pubkey : instruction.program_id;
+            bool found = false;
+            for (uint64_t j = 0; j != account_infos_len; ++j) {
+                found |= std::memcmp(account_infos[j].pubkey, key, 32) == 0;
+            }
+            if (!found) {
+                return 1;
+            }
+        }
+        return 0;
+    };
+
+    sol::host::report("user_registry_example", sol::host::benchmark(entrypoint, input, iterations));
+    return 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * Runs deposits into and withdrawals from the vault_example natively and reports their compute units
+ *
+ * Usage: vault_example_bench [iterations] [-v]
+ */
+
+#include <sol_host.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" unsigned long entrypoint(const unsigned char* input);
+
+namespace {
+
+// Anchor's sighash of the instruction, followed by the amount in the Borsh format
+std::vector<uint8_t> instruction_data(const std::string& name, uint64_t amount) {
+    const std::string preimage = "global:" + name;
+    uint8_t hash[32];
+    sol::host::sha256({{preimage.data(), preimage.size()}}, hash);
+    std::vector<uint8_t> data(hash, hash + 8);
+    for (int i = 0; i != 8; ++i) {
+        data.push_back(uint8_t(amount >> (8 * i)));
+    }
+    return data;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint64_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    sol::host::context().echo_logs = argc > 2 && std::strcmp(argv[2], "-v") == 0;
+
+    const uint8_t program_id[32] = {1};
+    const uint8_t authority[32] = {2};
+    const uint8_t vault[32] = {3};
+    const uint8_t recipient[32] = {4};
+    const uint8_t system_program[32] = {};
+
+    // discriminator and authority of an initialized vault
+    uint8_t discriminator[32];
+    sol::host::sha256({{"account:Vault", 13}}, discriminator);
+    uint8_t vault_data[40];
+    std::memcpy(vault_data, discriminator, 8);
+    std::memcpy(vault_data + 8, authority, 32);
+
+    const std::vector<uint8_t> deposit = instruction_data("deposit", 1000000);
+    sol::host::InputBuilder deposit_input;
+    deposit_input.program_id(program_id);
+    deposit_input.account(authority).signer().writable().set_lamports(1000000000).set_owner(system_program);
+    deposit_input.account(vault).writable().set_lamports(10000000).set_owner(program_id).set_data(
+        vault_data, sizeof(vault_data)
+    );
+    deposit_input.account(system_program).set_executable();
+    deposit_input.instruction_data(deposit.data(), deposit.size());
+
+    const std::vector<uint8_t> withdraw = instruction_data("withdraw", 1000000);
+    sol::host::InputBuilder withdraw_input;
+    withdraw_input.program_id(program_id);
+    withdraw_input.account(authority).signer();
+    withdraw_input.account(vault).writable().set_lamports(10000000).set_owner(program_id).set_data(
+        vault_data, sizeof(vault_data)
+    );
+    withdraw_input.account(recipient).writable();
+    withdraw_input.instruction_data(withdraw.data(), withdraw.size());
+
+    sol::host::report("vault_example deposit", sol::host::benchmark(entrypoint, deposit_input, iterations));
+    sol::host::report("vault_example withdraw", sol::host::benchmark(entrypoint, withdraw_input, iterations));
+    return 0;
+}
@@ -0,0 +1,541 @@
+/**
+ * Native implementations of the syscalls declared in sol_syscalls.h (see sol_host.h)
+ */
+
+// the SDK comes first, since <cstdint> defines macros such as INT8_MIN that sol_limits.h declares as constants
+#include <sol_base58.h>
+#include <sol_base64.h>
+#include <sol_hash.h>
+#include <sol_limits.h>
+#include <sol_pda.h>
+#include <sol_status_codes.h>
+#include <sol_syscalls.h>
+
+#include "sol_host.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+alignas(16) uint8_t sol_host_heap[256 * 1024];
+uint8_t* sol_host_input = nullptr;
+
+namespace sol::host {
+
+namespace {
+
+Context global_context;
+
+// offset of the next byte served by sol_alloc_free_, reset by every run
+uint64_t heap_position = 0;
+
+// size of the heap of the current run, all of which is zeroed, including the SysvarCache at its end
+uint64_t heap_end = 0;
+
+// the largest SOL_HEAP_SIZE registered by the SDK; constant-initialized, so registrations before main() find it
+uint64_t heap_size_required = 0;
+
+void log_message(std::string message) {
+    Context& ctx = context();
+    if (ctx.echo_logs) {
+        std::printf("%s\n", message.c_str());
+    }
+    ctx.logs.push_back(std::move(message));
+}
+
+// bytes logged by sol_log_pubkey_; the SDK encodes at most MAX_BASE58_DECODED_LEN of them
+std::string to_base58(const uint8_t* bytes, uint64_t len) {
+    char encoded[max_base58_len(MAX_BASE58_DECODED_LEN)];
+    return std::string(encoded, sol::to_base58(bytes, len, encoded, sizeof(encoded)));
+}
+
+} // namespace
+
+Context& context() {
+    return global_context;
+}
+
+uint64_t required_heap_size() {
+    return std::max(heap_size_required, MIN_HEAP_FRAME_BYTES);
+}
+
+void ComputeMeter::consume(uint64_t units) {
+    _consumed += units;
+    if (_consumed > costs.max_units) {
+        _consumed = costs.max_units;
+        throw Abort{"exceeded maximum compute units"};
+    }
+}
+
+void charge_instructions(uint64_t count) {
+    ComputeMeter& meter = context().meter;
+    meter.consume(count * meter.costs.instruction);
+}
+
+InputBuilder::Account& InputBuilder::Account::set_owner(const void* owner) {
+    std::memcpy(this->owner, owner, sizeof(this->owner));
+    return *this;
+}
+
+InputBuilder::Account& InputBuilder::Account::set_data(const void* data, uint64_t len) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    this->data.assign(bytes, bytes + len);
+    return *this;
+}
+
+InputBuilder::Account& InputBuilder::account(const void* pubkey) {
+    _accounts.emplace_back();
+    std::memcpy(_accounts.back().pubkey, pubkey, 32);
+    return _accounts.back();
+}
+
+void InputBuilder::duplicate(uint64_t index) {
+    _accounts.emplace_back();
+    _accounts.back().duplicate_of = index;
+}
+
+void InputBuilder::instruction_data(const void* data, uint64_t len) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    _instruction_data.assign(bytes, bytes + len);
+}
+
+void InputBuilder::program_id(const void* program_id) {
+    std::memcpy(_program_id, program_id, sizeof(_program_id));
+}
+
+std::vector<uint8_t> InputBuilder::build() const {
+    constexpr uint64_t MAX_PERMITTED_DATA_INCREASE = 1024 * 10;
+    std::vector<uint8_t> out;
+    auto append = [&out](const void* data, uint64_t len) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + len);
+    };
+    auto append_u64 = [&append](uint64_t value) {
+        append(&value, sizeof(value));
+    };
+
+    append_u64(_accounts.size());
+    for (const Account& account : _accounts) {
+        if (account.duplicate_of >= 0) {
+            out.push_back(uint8_t(account.duplicate_of));
+            out.resize(out.size() + 7); // padding
+            continue;
+        }
+        out.push_back(0xff);
+        out.push_back(account.is_signer);
+        out.push_back(account.is_writable);
+        out.push_back(account.executable);
+        out.resize(out.size() + 4); // padding
+        append(account.pubkey, 32);
+        append(account.owner, 32);
+        append_u64(account.lamports);
+        append_u64(account.data.size());
+        append(account.data.data(), account.data.size());
+        out.resize(out.size() + MAX_PERMITTED_DATA_INCREASE);
+        out.resize((out.size() + 7) & ~uint64_t(7));
+        append_u64(account.rent_epoch);
+    }
+    append_u64(_instruction_data.size());
+    append(_instruction_data.data(), _instruction_data.size());
+    append(_program_id, sizeof(_program_id));
+    return out;
+}
+
+Result run(Entrypoint entrypoint, const std::vector<uint8_t>& input) {
+    Context& ctx = context();
+    ctx.meter.reset();
+    ctx.logs.clear();
+    heap_end = ctx.heap_size != 0 ? ctx.heap_size : required_heap_size();
+    if (heap_end > sizeof(sol_host_heap)) {
+        throw std::length_error("heap_size exceeds the maximum heap frame");
+    }
+    if (heap_end < heap_size_required) {
+        throw std::length_error("heap_size is less than the program's SOL_HEAP_SIZE");
+    }
+    std::memset(sol_host_heap, 0, heap_end);
+    heap_position = 0;
+
+    // the program may write to its input, so it always gets a fresh copy in 8-byte aligned memory
+    std::vector<uint64_t> buffer((input.size() + 7) / 8);
+    std::memcpy(buffer.data(), input.data(), input.size());
+    sol_host_input = reinterpret_cast<uint8_t*>(buffer.data());
+
+    Result result;
+    try {
+        result.status = entrypoint(reinterpret_cast<const unsigned char*>(buffer.data()));
+    } catch (const Abort& abort) {
+        result.aborted = true;
+        result.reason = abort.reason;
+    } catch (...) {
+        sol_host_input = nullptr;
+        throw;
+    }
+    sol_host_input = nullptr; // the buffer is freed on return
+    result.units = ctx.meter.consumed();
+    result.syscalls = ctx.meter.syscalls();
+    return result;
+}
+
+Result run(Entrypoint entrypoint, const InputBuilder& input) {
+    return run(entrypoint, input.build());
+}
+
+BenchmarkResult benchmark(Entrypoint entrypoint, const InputBuilder& input, uint64_t iterations) {
+    const std::vector<uint8_t> serialized = input.build();
+    BenchmarkResult result;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i != iterations; ++i) {
+        result.last = run(entrypoint, serialized);
+        if (i == 0 || result.last.units < result.min_units) {
+            result.min_units = result.last.units;
+        }
+        if (result.last.units > result.max_units) {
+            result.max_units = result.last.units;
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (iterations != 0) {
+        result.nanoseconds = double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations;
+    }
+    return result;
+}
+
+void report(const char* name, const BenchmarkResult& result) {
+    std::printf(
+        "%-32s %8lu CU (min %lu, max %lu) %6lu syscalls %10.0f ns  %s\n",
+        name,
+        result.last.units,
+        result.min_units,
+        result.max_units,
+        result.last.syscalls,
+        result.nanoseconds,
+        result.last.aborted ? result.last.reason.c_str() : ("status " + std::to_string(result.last.status)).c_str()
+    );
+}
+
+std::string to_base64(const uint8_t* bytes, uint64_t len) {
+    std::string result(base64_len(len), '\0');
+    sol::to_base64(bytes, len, result.data(), result.size());
+    return result;
+}
+
+bool from_base64(const std::string& encoded, std::vector<uint8_t>& bytes) {
+    bytes.clear();
+    if (encoded.size() % 4 != 0) {
+        return false;
+    }
+    for (uint64_t i = 0; i != encoded.size(); i += 4) {
+        uint32_t group = 0;
+        int padding = 0;
+        for (int j = 0; j != 4; ++j) {
+            const char c = encoded[i + j];
+            const char* digit = c != '\0' ? std::strchr(map_to_base64, c) : nullptr;
+            if (c == '=' && i + 4 == encoded.size() && j >= 2 && (j == 3 || encoded[i + 3] == '=')) {
+                ++padding;
+            } else if (digit == nullptr || padding != 0) {
+                return false;
+            }
+            group = group << 6 | (digit != nullptr ? uint32_t(digit - map_to_base64) : 0);
+        }
+        bytes.push_back(uint8_t(group >> 16));
+        if (padding < 2) {
+            bytes.push_back(uint8_t(group >> 8));
+        }
+        if (padding < 1) {
+            bytes.push_back(uint8_t(group));
+        }
+    }
+    return true;
+}
+
+std::vector<std::vector<uint8_t>> program_data(const std::string& message) {
+    static const std::string prefix = "Program data: ";
+    std::vector<std::vector<uint8_t>> fields;
+    if (message.compare(0, prefix.size(), prefix) != 0) {
+        return fields;
+    }
+    uint64_t start = prefix.size();
+    while (start <= message.size()) {
+        uint64_t end = message.find(' ', start);
+        if (end == std::string::npos) {
+            end = message.size();
+        }
+        std::vector<uint8_t> field;
+        if (!from_base64(message.substr(start, end - start), field)) {
+            return {};
+        }
+        fields.push_back(std::move(field));
+        start = end + 1;
+    }
+    return fields;
+}
+
+void sha256(const std::vector<std::pair<const void*, uint64_t>>& parts, uint8_t* result) {
+    ConstSha256 hasher;
+    for (const auto& part : parts) {
+        hasher.update(static_cast<const uint8_t*>(part.first), part.second);
+    }
+    const Hash digest = hasher.finish();
+    std::memcpy(result, digest.bytes, sizeof(digest.bytes));
+}
+
+bool is_on_curve(const uint8_t* point) {
+    return internal::is_on_curve(*reinterpret_cast<const uint8_t(*)[32]>(point));
+}
+
+bool create_program_address(const std::vector<std::pair<const void*, uint64_t>>& seeds, const void* program_id, uint8_t* address) {
+    static const char marker[] = "ProgramDerivedAddress";
+    if (seeds.size() > MAX_SEEDS) {
+        return false;
+    }
+    for (const std::pair<const void*, uint64_t>& seed : seeds) {
+        if (seed.second > MAX_SEED_LEN) {
+            return false;
+        }
+    }
+    std::vector<std::pair<const void*, uint64_t>> parts = seeds;
+    parts.emplace_back(program_id, 32);
+    parts.emplace_back(marker, sizeof(marker) - 1);
+    sha256(parts, address);
+    return !is_on_curve(address);
+}
+
+bool find_program_address(const std::vector<std::pair<const void*, uint64_t>>& seeds, const void* program_id, uint8_t* address, uint8_t* bump_seed) {
+    std::vector<std::pair<const void*, uint64_t>> parts = seeds;
+    for (int bump = 255; bump > 0; --bump) {
+        *bump_seed = bump;
+        parts.resize(seeds.size());
+        parts.emplace_back(bump_seed, 1);
+        if (create_program_address(parts, program_id, address)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace sol::host
+
+void sol_host_require_heap(uint64_t size) {
+    sol::host::heap_size_required = std::max(sol::host::heap_size_required, size);
+}
+
+using sol::host::context;
+
+namespace {
+
+// like the runtime, aborts the program for more than MAX_SEEDS seeds or a seed longer than MAX_SEED_LEN
+std::vector<std::pair<const void*, uint64_t>> to_parts(const sol::SignerSeed* seeds, int seeds_len) {
+    if (seeds_len < 0 || uint64_t(seeds_len) > sol::MAX_SEEDS) {
+        throw sol::host::Abort{"bad seeds: exceeded the maximum number of seeds"};
+    }
+    const sol::host::RawSeed* raw = reinterpret_cast<const sol::host::RawSeed*>(seeds);
+    std::vector<std::pair<const void*, uint64_t>> parts;
+    for (int i = 0; i != seeds_len; ++i) {
+        if (raw[i].len > sol::MAX_SEED_LEN) {
+            throw sol::host::Abort{"bad seeds: a seed is longer than " + std::to_string(sol::MAX_SEED_LEN) + " bytes"};
+        }
+        parts.emplace_back(raw[i].addr, raw[i].len);
+    }
+    return parts;
+}
+
+uint64_t mem_op_cost(uint64_t len) {
+    const sol::host::CostTable& costs = context().meter.costs;
+    const uint64_t per_byte = len / costs.cpi_bytes_per_unit;
+    return per_byte > costs.mem_op_base ? per_byte : costs.mem_op_base;
+}
+
+template<class HASHER>
+uint64_t hash(const sol::Bytes* bytes, int bytes_len, sol::uint8_t* result) {
+    sol::host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.sha256_base);
+    const sol::host::RawSeed* parts = reinterpret_cast<const sol::host::RawSeed*>(bytes);
+    HASHER hasher;
+    for (int i = 0; i != bytes_len; ++i) {
+        meter.consume(meter.costs.sha256_byte * (parts[i].len / 2));
+        hasher.update(parts[i].addr, parts[i].len);
+    }
+    const sol::Hash digest = hasher.finish();
+    std::memcpy(result, digest.bytes, sizeof(digest.bytes));
+    return sol::SUCCESS;
+}
+
+template<class SYSVAR_DATA, class SYSVAR>
+uint64_t get_sysvar(const SYSVAR_DATA& data, SYSVAR* sysvar) {
+    sol::host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.sysvar_base + sizeof(SYSVAR_DATA));
+    std::memcpy(static_cast<void*>(sysvar), &data, sizeof(SYSVAR_DATA));
+    return sol::SUCCESS;
+}
+
+} // namespace
+
+namespace sol::syscall {
+
+void sol_log_(const char* message, uint64_t len) {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.log);
+    host::log_message("Program log: " + std::string(message, len));
+}
+
+void sol_log_64_(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t e) {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.log_64);
+    char message[160];
+    std::snprintf(message, sizeof(message), "Program log: %#lx, %#lx, %#lx, %#lx, %#lx", a, b, c, d, e);
+    host::log_message(message);
+}
+
+void sol_log_compute_units_() {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.syscall_base);
+    host::log_message("Program consumption: " + std::to_string(meter.remaining()) + " units remaining");
+}
+
+void sol_log_pubkey(const Pubkey* pubkey) {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.log_pubkey);
+    host::log_message("Program log: " + host::to_base58(reinterpret_cast<const uint8_t*>(pubkey), 32));
+}
+
+void sol_log_data(const Bytes* data, uint64_t data_len) {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.syscall_base + meter.costs.syscall_base * data_len);
+    const host::RawSeed* fields = reinterpret_cast<const host::RawSeed*>(data);
+    std::string message = "Program data:";
+    for (uint64_t i = 0; i != data_len; ++i) {
+        meter.consume(meter.costs.log_data_byte * fields[i].len);
+        message += " " + host::to_base64(fields[i].addr, fields[i].len);
+    }
+    host::log_message(message);
+}
+
+void* sol_alloc_free_(uint64_t size, void* ptr) {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.alloc_free);
+    if (ptr != nullptr) {
+        return nullptr; // like the runtime's bump allocator, free is a no-op
+    }
+    const uint64_t start = (host::heap_position + 15) & ~uint64_t(15);
+    if (start + size > host::heap_end) {
+        return nullptr;
+    }
+    host::heap_position = start + size;
+    return sol_host_heap + start;
+}
+
+void sol_panic_(const char* file, uint64_t len, uint64_t line, uint64_t column) {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.syscall_base);
+    const std::string location = std::string(file, len && file[len - 1] == '\0' ? len - 1 : len) + ":" + std::to_string(line) + ":" + std::to_string(column);
+    host::log_message("Program panicked at " + location);
+    throw host::Abort{"panicked at " + location};
+}
+
+uint64_t sol_keccak256(const Bytes* bytes, int bytes_len, uint8_t* result) {
+    return hash<ConstKeccak256>(bytes, bytes_len, result);
+}
+
+uint64_t sol_sha256(const Bytes* bytes, int bytes_len, uint8_t* result) {
+    return hash<ConstSha256>(bytes, bytes_len, result);
+}
+
+uint64_t sol_create_program_address(const SignerSeed* seeds, int seeds_len, const Pubkey* program_id, Pubkey* program_address) {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(meter.costs.create_program_address);
+    // the runtime returns 1 rather than a ProgramError for an address on the curve
+    if (!host::create_program_address(to_parts(seeds, seeds_len), program_id, reinterpret_cast<uint8_t*>(program_address))) {
+        return 1;
+    }
+    return SUCCESS;
+}
+
+uint64_t sol_try_find_program_address(const SignerSeed* seeds, int seeds_len, const Pubkey* program_id, Pubkey* program_address, uint8_t* bump_seed) {
+    host::ComputeMeter& meter = context().meter;
+    meter.syscall(0);
+    const std::vector<std::pair<const void*, uint64_t>> parts = to_parts(seeds, seeds_len);
+    std::vector<std::pair<const void*, uint64_t>> candidate = parts;
+    for (int bump = 255; bump > 0; --bump) {
+        meter.consume(meter.costs.create_program_address);
+        *bump_seed = bump;
+        candidate.resize(parts.size());
+        candidate.emplace_back(bump_seed, 1);
+        if (host::create_program_address(candidate, program_id, reinterpret_cast<uint8_t*>(program_address))) {
+            return SUCCESS;
+        }
+    }
+    return 1; // also with MAX_SEEDS seeds, which leave no room for the bump seed
+}
+
+uint64_t sol_invoke_signed_c(
+    const Instruction* instruction,
+    const AccountInfo* account_infos,
+    int account_infos_len,
+    const SignerSeeds* signers_seeds,
+    int signers_seeds_len
+) {
+    host::Context& ctx = context();
+    const host::RawInstruction& raw = *reinterpret_cast<const host::RawInstruction*>(instruction);
+    ctx.meter.syscall(ctx.meter.costs.invoke);
+    ctx.meter.consume(raw.data_len / ctx.meter.costs.cpi_bytes_per_unit);
+    if (!ctx.invoke) {
+        return SUCCESS;
+    }
+    const host::RawAccountInfo* raw_infos = reinterpret_cast<const host::RawAccountInfo*>(account_infos);
+    const uint64_t result = ctx.invoke(
+        raw,
+        raw_infos,
+        account_infos_len,
+        reinterpret_cast<const host::RawSeeds*>(signers_seeds),
+        signers_seeds_len
+    );
+    // like the runtime, store the lengths of resized accounts in the input as well, which precede their data
+    for (uint64_t i = 0; i != uint64_t(account_infos_len); ++i) {
+        std::memcpy(raw_infos[i].data - sizeof(uint64_t), &raw_infos[i].data_len, sizeof(uint64_t));
+    }
+    return result;
+}
+
+uint64_t sol_get_clock_sysvar(sysvar::Clock* clock) {
+    return get_sysvar(context().clock, clock);
+}
+
+uint64_t sol_get_epoch_schedule_sysvar(sysvar::EpochSchedule* epoch_schedule) {
+    return get_sysvar(context().epoch_schedule, epoch_schedule);
+}
+
+uint64_t sol_get_rent_sysvar(sysvar::Rent* rent) {
+    return get_sysvar(context().rent, rent);
+}
+
+void sol_memcpy_(void* dst, const void* src, uint64_t len) {
+    context().meter.syscall(mem_op_cost(len));
+    std::memcpy(dst, src, len);
+}
+
+void sol_memmove_(void* dst, const void* src, uint64_t len) {
+    context().meter.syscall(mem_op_cost(len));
+    std::memmove(dst, src, len);
+}
+
+void sol_memcmp_(const void* left, const void* right, uint64_t len, int32_t* result) {
+    context().meter.syscall(mem_op_cost(len));
+    const uint8_t* a = static_cast<const uint8_t*>(left);
+    const uint8_t* b = static_cast<const uint8_t*>(right);
+    *result = 0;
+    for (uint64_t i = 0; i != len; ++i) {
+        if (a[i] != b[i]) {
+            *result = int32_t(a[i]) - int32_t(b[i]);
+            return;
+        }
+    }
+}
+
+void sol_memset_(void* dst, uint64_t byte, uint64_t len) {
+    context().meter.syscall(mem_op_cost(len));
+    std::memset(dst, int(byte), len);
+}
+
+} // namespace sol::syscall
@@ -0,0 +1,268 @@
+#pragma once
+/**
+ * Host-side emulation of the Solana syscalls, for running and benchmarking programs natively
+ *
+ * libsol_host implements every function declared in sol_syscalls.h, so that a program's entrypoint can be linked into an
+ * ordinary executable and called in a loop. Each syscall charges compute units according to a CostTable, which defaults
+ * to the values of the Solana 1.7 runtime. A run is aborted like on-chain when the budget is exhausted or sol_panic() is
+ * called.
+ *
+ * Example:
+ * host::InputBuilder input;
+ * input.program_id(program_id);
+ * input.account(payer_key).signer().writable().set_lamports(1000000000);
+ * input.instruction_data("myname", 6);
+ * host::Result result = host::run(entrypoint, input);
+ * printf("status %lu, %lu compute units\n", result.status, result.units);
+ *
+ * The native machine code executes a different number of instructions than the BPF code, so only syscalls are metered
+ * automatically. Callers may add an estimate for the program's own work with charge_instructions().
+ *
+ * This library is meant for x86-64 Linux and uses the C++ standard library; it must not be included in on-chain programs.
+ */
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+// the program heap and input, in place of the fixed addresses used on-chain; SDK headers find them when SOL_HOST is defined
+extern "C" uint8_t sol_host_heap[];
+extern "C" uint8_t* sol_host_input;
+// called by the SDK for the SOL_HEAP_SIZE of each of the program's translation units (see sol_arena.h)
+extern "C" void sol_host_require_heap(uint64_t size);
+
+namespace sol::host {
+
+using Entrypoint = unsigned long (*)(const unsigned char* input);
+
+// Compute-unit costs of the syscalls; see BpfComputeBudget in solana/sdk/src/process_instruction.rs
+struct CostTable {
+    uint64_t max_units = 200000;                 // budget of a single program invocation
+    uint64_t instruction = 1;                    // per BPF instruction, charged via charge_instructions()
+    uint64_t syscall_base = 100;                 // sol_panic_ and syscalls without a dedicated cost
+    uint64_t log = 100;                          // sol_log_
+    uint64_t log_64 = 100;                       // sol_log_64_
+    uint64_t log_pubkey = 100;                   // sol_log_pubkey
+    uint64_t log_data_byte = 1;                  // sol_log_data per byte, after syscall_base per field and one more
+    uint64_t sha256_base = 85;                   // sol_sha256 and sol_keccak256
+    uint64_t sha256_byte = 1;                    // ...plus this for every 2 bytes hashed
+    uint64_t create_program_address = 1500;      // per candidate address, also in sol_try_find_program_address
+    uint64_t invoke = 1000;                      // sol_invoke_signed_c
+    uint64_t cpi_bytes_per_unit = 250;           // bytes of instruction data covered by a compute unit
+    uint64_t sysvar_base = 100;                  // sol_get_*_sysvar, plus one unit per byte of the sysvar
+    uint64_t mem_op_base = 15;                   // sol_mem*_, or length / cpi_bytes_per_unit if that's higher
+    uint64_t alloc_free = 0;                     // sol_alloc_free_ is not metered by the runtime
+};
+
+// Counts the compute units consumed by the current run
+class ComputeMeter {
+    uint64_t _consumed = 0;
+    uint64_t _syscalls = 0;
+
+public:
+    CostTable costs;
+
+    void reset() {
+        _consumed = 0;
+        _syscalls = 0;
+    }
+
+    // throws Abort once more than costs.max_units have been consumed
+    void consume(uint64_t units);
+
+    // consume() for the base cost of a syscall
+    void syscall(uint64_t units) {
+        ++_syscalls;
+        consume(units);
+    }
+
+    uint64_t consumed() const {
+        return _consumed;
+    }
+
+    uint64_t remaining() const {
+        return _consumed < costs.max_units ? costs.max_units - _consumed : 0;
+    }
+
+    uint64_t syscalls() const {
+        return _syscalls;
+    }
+};
+
+// Thrown out of sol_panic_ and the ComputeMeter to unwind the program back to run()
+struct Abort {
+    std::string reason;
+};
+
+// Layout of the sysvars as returned by the runtime
+struct ClockData {
+    uint64_t slot = 0;
+    int64_t epoch_start_timestamp = 0;
+    uint64_t epoch = 0;
+    uint64_t leader_schedule_epoch = 0;
+    int64_t unix_timestamp = 0;
+};
+
+struct EpochScheduleData {
+    uint64_t slots_per_epoch = 432000;
+    uint64_t leader_schedule_slot_offset = 432000;
+    bool warmup = true;
+    uint64_t first_normal_epoch = 14;
+    uint64_t first_normal_slot = 524256;
+};
+
+struct RentData {
+    uint64_t lamports_per_byte_year = 3480;
+    double exemption_threshold = 2.0;
+    uint8_t burn_percent = 50;
+};
+
+// Layout of AccountMeta, Instruction and SignerSeed(s) as passed to the syscalls (see sol_account.h and sol_instruction.h)
+struct RawAccountMeta {
+    const uint8_t* pubkey;
+    bool is_writable;
+    bool is_signer;
+};
+
+struct RawInstruction {
+    const uint8_t* program_id;
+    const RawAccountMeta* accounts;
+    uint64_t accounts_len;
+    const uint8_t* data;
+    uint64_t data_len;
+};
+
+struct RawSeed {
+    const uint8_t* addr;
+    uint64_t len;
+};
+
+struct RawSeeds {
+    const RawSeed* addr;
+    uint64_t len;
+};
+
+// Layout of AccountInfo (see sol_account.h)
+struct RawAccountInfo {
+    const uint8_t* pubkey;
+    uint64_t* lamports;
+    uint64_t data_len;
+    uint8_t* data;
+    const uint8_t* owner;
+    uint64_t rent_epoch;
+    bool is_signer;
+    bool is_writable;
+    bool executable;
+};
+
+// Handles cross-program invocations; the default handler succeeds without doing anything
+using InvokeHandler = std::function<uint64_t(
+    const RawInstruction& instruction,
+    const RawAccountInfo* account_infos,
+    uint64_t account_infos_len,
+    const RawSeeds* signers_seeds,
+    uint64_t signers_seeds_len
+)>;
+
+// State shared by all emulated syscalls
+struct Context {
+    ComputeMeter meter;
+    ClockData clock;
+    EpochScheduleData epoch_schedule;
+    RentData rent;
+    InvokeHandler invoke;
+    std::vector<std::string> logs;  // messages logged during the current run
+    bool echo_logs = false;         // print log messages to stdout as they occur
+    uint64_t heap_size = 0;         // size of the heap, at most 256 KB; 0 for required_heap_size()
+};
+
+// the context used by the syscalls
+Context& context();
+
+// the largest SOL_HEAP_SIZE the program was compiled with, or 32 KB; run() fails for a smaller Context::heap_size
+uint64_t required_heap_size();
+
+// adds an estimate of the BPF instructions executed by the program itself
+void charge_instructions(uint64_t count);
+
+// Serializes accounts, instruction data and the program id the way the BPF loader does (see sol_serialization.h)
+class InputBuilder {
+public:
+    struct Account {
+        uint8_t pubkey[32] = {};
+        uint8_t owner[32] = {};
+        uint64_t lamports = 0;
+        std::vector<uint8_t> data;
+        uint64_t rent_epoch = 0;
+        bool is_signer = false;
+        bool is_writable = false;
+        bool executable = false;
+        int64_t duplicate_of = -1;
+
+        Account& signer(bool is_signer = true) { this->is_signer = is_signer; return *this; }
+        Account& writable(bool is_writable = true) { this->is_writable = is_writable; return *this; }
+        Account& set_executable(bool executable = true) { this->executable = executable; return *this; }
+        Account& set_lamports(uint64_t lamports) { this->lamports = lamports; return *this; }
+        Account& set_owner(const void* owner);
+        Account& set_data(const void* data, uint64_t len);
+    };
+
+    // appends an account and returns it for setting its properties
+    Account& account(const void* pubkey);
+
+    // appends a duplicate of the account at the given index
+    void duplicate(uint64_t index);
+
+    void instruction_data(const void* data, uint64_t len);
+    void program_id(const void* program_id);
+
+    // the serialized input to be passed to the entrypoint
+    std::vector<uint8_t> build() const;
+
+private:
+    std::deque<Account> _accounts; // stable references for chained setters
+    std::vector<uint8_t> _instruction_data;
+    uint8_t _program_id[32] = {};
+};
+
+struct Result {
+    uint64_t status = 0;      // the entrypoint's return value, if it returned
+    bool aborted = false;     // sol_panic() was called or the compute budget was exceeded
+    std::string reason;       // why the run was aborted
+    uint64_t units = 0;       // compute units consumed
+    uint64_t syscalls = 0;    // number of syscalls made
+};
+
+// calls the entrypoint on a copy of the input, with a fresh compute meter and heap
+Result run(Entrypoint entrypoint, const std::vector<uint8_t>& input);
+Result run(Entrypoint entrypoint, const InputBuilder& input);
+
+struct BenchmarkResult {
+    Result last;              // result of the final iteration
+    uint64_t min_units = 0;
+    uint64_t max_units = 0;
+    double nanoseconds = 0;   // average wall-clock time per iteration
+};
+
+// calls the entrypoint repeatedly and reports compute units and native run time
+BenchmarkResult benchmark(Entrypoint entrypoint, const InputBuilder& input, uint64_t iterations);
+
+// prints a one-line summary of the benchmark to stdout
+void report(const char* name, const BenchmarkResult& result);
+
+// Base64 with padding, as used in "Program data:" messages; from_base64 returns false for invalid input
+std::string to_base64(const uint8_t* bytes, uint64_t len);
+bool from_base64(const std::string& encoded, std::vector<uint8_t>& bytes);
+
+// the fields of a message logged by sol_log_data (see sol_event.h), or none for other messages
+std::vector<std::vector<uint8_t>> program_data(const std::string& message);
+
+// SHA-256 and the program address derivation used by the syscalls, for preparing inputs
+void sha256(const std::vector<std::pair<const void*, uint64_t>>& parts, uint8_t* result);
+bool is_on_curve(const uint8_t* point);
+bool create_program_address(const std::vector<std::pair<const void*, uint64_t>>& seeds, const void* program_id, uint8_t* address);
+bool find_program_address(const std::vector<std::pair<const void*, uint64_t>>& seeds, const void* program_id, uint8_t* address, uint8_t* bump_seed);
+
+} // namespace sol::host
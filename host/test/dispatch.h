@@ -0,0 +1,92 @@
+#pragma once
+/**
+ * A program with 40 Sighash handlers, run by dispatch_test and, without a perfect hash, dispatch_binary_search_test
+ */
+
+#include <sol_entrypoint.h>
+#include <sol_hash.h>
+
+#include "sol_host.h"
+#include "test.h"
+
+#include <string>
+
+constexpr sol::uint64_t HANDLERS = 40;
+
+// returns a status identifying the handler
+template<sol::uint64_t I>
+sol::uint64_t handler(const sol::InstructionContext&) {
+    return 1000 + I;
+}
+
+#define HANDLER(I) ::sol::Sighash<::sol::instruction_discriminator("handler_" #I), handler<I>>
+
+using Program = sol::Dispatcher<
+    HANDLER(0),
+    HANDLER(1),
+    HANDLER(2),
+    HANDLER(3),
+    HANDLER(4),
+    HANDLER(5),
+    HANDLER(6),
+    HANDLER(7),
+    HANDLER(8),
+    HANDLER(9),
+    HANDLER(10),
+    HANDLER(11),
+    HANDLER(12),
+    HANDLER(13),
+    HANDLER(14),
+    HANDLER(15),
+    HANDLER(16),
+    HANDLER(17),
+    HANDLER(18),
+    HANDLER(19),
+    HANDLER(20),
+    HANDLER(21),
+    HANDLER(22),
+    HANDLER(23),
+    HANDLER(24),
+    HANDLER(25),
+    HANDLER(26),
+    HANDLER(27),
+    HANDLER(28),
+    HANDLER(29),
+    HANDLER(30),
+    HANDLER(31),
+    HANDLER(32),
+    HANDLER(33),
+    HANDLER(34),
+    HANDLER(35),
+    HANDLER(36),
+    HANDLER(37),
+    HANDLER(38),
+    HANDLER(39)
+>;
+
+extern "C" sol::uint64_t entrypoint(const sol::uint8_t* input) {
+    return Program::dispatch(input);
+}
+
+// runs the program with the given instruction data
+inline sol::host::Result run(const sol::uint8_t* data, sol::uint64_t len) {
+    const sol::uint8_t program_id[32] = {1};
+    sol::host::InputBuilder input;
+    input.program_id(program_id);
+    input.instruction_data(data, len);
+    return sol::host::run(entrypoint, input);
+}
+
+// checks that each handler is found by its sighash, and that other data is rejected
+inline void check_dispatch() {
+    for (sol::uint64_t i = 0; i != HANDLERS; ++i) {
+        const std::string preimage = "global:handler_" + std::to_string(i);
+        sol::uint8_t hash[32];
+        sol::host::sha256({{preimage.data(), preimage.size()}}, hash);
+        const sol::host::Result result = run(hash, 8);
+        CHECK(!result.aborted && result.status == 1000 + i);
+    }
+    const sol::uint8_t unknown[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    CHECK(run(unknown, sizeof(unknown)).status == sol::error::INVALID_INSTRUCTION_DATA);
+    CHECK(run(unknown, 7).status == sol::error::INVALID_INSTRUCTION_DATA);
+}
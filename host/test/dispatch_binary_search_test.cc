@@ -0,0 +1,15 @@
+/**
+ * Dispatches to 40 Sighash handlers by binary search, as no multiplier is tried for a perfect hash
+ */
+
+#define SOL_PERFECT_HASH_ATTEMPTS 0
+
+#include "dispatch.h"
+
+static_assert(Program::BINARY_SEARCH, "a perfect hash was found without attempts");
+
+int main() {
+    check_dispatch();
+    std::printf("dispatch_binary_search_test passed\n");
+    return 0;
+}
@@ -0,0 +1,13 @@
+/**
+ * Dispatches to 40 Sighash handlers by the perfect hash the compiler finds for them
+ */
+
+#include "dispatch.h"
+
+static_assert(!Program::BINARY_SEARCH, "no perfect hash found for 40 handlers");
+
+int main() {
+    check_dispatch();
+    std::printf("dispatch_test passed\n");
+    return 0;
+}
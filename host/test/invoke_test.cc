@@ -0,0 +1,113 @@
+/**
+ * Makes cross-program invocations with the AccountInfo table a SOL_ENTRYPOINT handler gets, checking what's passed
+ */
+
+#include <solana_cpp_sdk.h>
+
+#include "sol_host.h"
+#include "test.h"
+
+#include <vector>
+
+using namespace sol;
+
+namespace {
+
+// what the last invocation passed
+struct Invocation {
+    std::vector<uint64_t> data_lens;
+    std::vector<uint8_t> first_key_bytes;
+    uint64_t signers = 0;
+};
+
+Invocation last;
+
+// grows the account through a copy of its AccountInfo, so that the table's length is stale, then invokes the program
+// at index 2 with the account, by each of the pointer overloads in turn
+uint64_t invoke_all(const InstructionContext& context) {
+    AccountInfo grown = context.account_infos[1];
+    if (grown.realloc(16, true) != SUCCESS) {
+        return 100;
+    }
+    InstructionBuilder<1, 0> instruction(context.account_infos[2].pubkey());
+    instruction.writable(context.account_infos[1].pubkey());
+
+    const uint8_t seed = 7;
+    switch (context.data_len != 0 ? context.data[0] : 0) {
+    case 0:
+        return invoke(instruction, context.account_infos, context.accounts_given);
+    case 1:
+        return invoke_signed(instruction, context.account_infos, context.accounts_given, {{{SignerSeed(seed)}}});
+    case 2:
+        return invoke_subset<2, 1>(instruction, context.account_infos, context.accounts_given);
+    case 3:
+        return invoke_signed_subset<1, 2>(instruction, context.account_infos, context.accounts_given, {{{SignerSeed(seed)}}});
+    case 4:
+        return invoke_referenced(instruction, context.account_infos, context.accounts_given);
+    case 5:
+        return invoke_signed_referenced(instruction, context.account_infos, context.accounts_given, {{{SignerSeed(seed)}}});
+    default:
+        return invoke_subset<3>(instruction, context.account_infos, context.accounts_given);
+    }
+}
+
+} // namespace
+
+SOL_ENTRYPOINT(
+    Tag<0, invoke_all>
+)
+
+int main() {
+    host::Context& context = host::context();
+    context.invoke = [](
+        const host::RawInstruction&,
+        const host::RawAccountInfo* account_infos,
+        uint64_t account_infos_len,
+        const host::RawSeeds*,
+        uint64_t signers_seeds_len
+    ) {
+        last = Invocation();
+        for (uint64_t i = 0; i != account_infos_len; ++i) {
+            last.data_lens.push_back(account_infos[i].data_len);
+        }
+        last.first_key_bytes.push_back(account_infos[0].pubkey[0]);
+        last.signers = signers_seeds_len;
+        return uint64_t(SUCCESS);
+    };
+
+    const uint8_t program_id[32] = {1};
+    const uint8_t payer[32] = {2};
+    const uint8_t account[32] = {3};
+    const uint8_t invoked[32] = {4};
+    const uint8_t account_data[8] = {};
+
+    for (uint8_t variant = 0; variant != 7; ++variant) {
+        const uint8_t data[] = {0, variant};
+        host::InputBuilder input;
+        input.program_id(program_id);
+        input.account(payer).signer().writable();
+        input.account(account).writable().set_owner(program_id).set_data(account_data, sizeof(account_data));
+        input.account(invoked);
+        input.instruction_data(data, sizeof(data));
+
+        last = Invocation();
+        const host::Result result = host::run(entrypoint, input);
+        CHECK(!result.aborted);
+        if (variant == 6) {
+            CHECK(result.status == error::NOT_ENOUGH_ACCOUNT_KEYS && last.data_lens.empty());
+            continue;
+        }
+        CHECK(result.status == SUCCESS);
+        CHECK(last.signers == (variant % 2 == 1 ? 1u : 0u));
+        if (variant < 2) {
+            CHECK(last.data_lens == std::vector<uint64_t>({0, 16, 0}));
+        } else if (variant == 2) {
+            CHECK(last.data_lens == std::vector<uint64_t>({0, 16}) && last.first_key_bytes[0] == invoked[0]);
+        } else {
+            CHECK(last.data_lens == std::vector<uint64_t>({16, 0}) && last.first_key_bytes[0] == account[0]);
+        }
+    }
+
+    std::printf("invoke_test passed\n");
+    return 0;
+}
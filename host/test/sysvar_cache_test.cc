@@ -0,0 +1,47 @@
+/**
+ * Runs a program whose heap is larger than 32 KB twice, checking that its SysvarCache starts empty in each run
+ */
+
+#define SOL_HEAP_SIZE (64 * 1024)
+
+#include <sol_sysvar_cache.h>
+
+#include "sol_host.h"
+#include "test.h"
+
+#include <stdexcept>
+
+// returns the current slot, read twice to fill the cache and then hit it
+extern "C" unsigned long entrypoint(const unsigned char*) {
+    const sol::uint64_t first = sol::SysvarCache().clock().slot();
+    return first == sol::SysvarCache().clock().slot() ? first : 0;
+}
+
+int main() {
+    sol::host::Context& context = sol::host::context();
+    CHECK(sol::host::required_heap_size() == SOL_HEAP_SIZE);
+    const sol::host::InputBuilder input;
+
+    for (uint64_t heap_size : {uint64_t(0), uint64_t(SOL_HEAP_SIZE), uint64_t(256 * 1024)}) {
+        context.heap_size = heap_size;
+        context.clock.slot = 100;
+        sol::host::Result result = sol::host::run(entrypoint, input);
+        CHECK(!result.aborted && result.status == 100 && result.syscalls == 1);
+
+        context.clock.slot = 200;
+        result = sol::host::run(entrypoint, input);
+        CHECK(!result.aborted && result.status == 200 && result.syscalls == 1);
+    }
+
+    context.heap_size = 32 * 1024;
+    bool rejected = false;
+    try {
+        sol::host::run(entrypoint, input);
+    } catch (const std::length_error&) {
+        rejected = true;
+    }
+    CHECK(rejected);
+
+    std::printf("sysvar_cache_test passed\n");
+    return 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+/**
+ * Minimal checks for the native tests in this directory, each of which is an executable run by `make test`
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+// prints the failed condition and exits with status 1
+#define CHECK(condition)                                                            \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            std::exit(1);                                                           \
+        }                                                                           \
+    } while (false)
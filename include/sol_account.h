@@ -7,8 +7,12 @@
  */
 
 #include <sol_int.h>
+#include <sol_limits.h>
+#include <sol_log_line.h>
 #include <sol_logging.h>
+#include <sol_memory.h>
 #include <sol_pubkey.h>
+#include <sol_status_codes.h>
 #include <sol_syscalls.h>
 
 namespace sol {
@@ -16,20 +20,50 @@ namespace sol {
 class AccountInfo;
 class Pubkey;
 
+namespace internal {
+
+class AccountParser;
+void refresh_data_lens(const AccountInfo* account_infos, uint64_t count);
+
+// The length fields of a serialized account, located relative to its data. The 4 bytes of padding after the flags are
+// zero in the input; once the length changes, they record the original length plus one, as the layout depends on it.
+constexpr uint64_t DATA_LEN_BEFORE_DATA = sizeof(uint64_t);
+constexpr uint64_t ORIGINAL_DATA_LEN_BEFORE_DATA = sizeof(uint32_t) + 2 * sizeof(Pubkey) + 2 * sizeof(uint64_t);
+
+inline uint64_t& serialized_data_len(uint8_t* data) {
+    return *reinterpret_cast<uint64_t*>(data - DATA_LEN_BEFORE_DATA);
+}
+
+inline const uint64_t& serialized_data_len(const uint8_t* data) {
+    return *reinterpret_cast<const uint64_t*>(data - DATA_LEN_BEFORE_DATA);
+}
+
+// the data length at the start of the invocation, after which MAX_PERMITTED_DATA_INCREASE bytes are reserved
+inline uint64_t original_data_len(const uint8_t* data) {
+    const uint32_t recorded = *reinterpret_cast<const uint32_t*>(data - ORIGINAL_DATA_LEN_BEFORE_DATA);
+    return recorded != 0 ? recorded - 1 : serialized_data_len(data);
+}
+
+// must be called before the length changes for the first time; accounts hold at most 10 MB
+inline void record_original_data_len(uint8_t* data) {
+    uint32_t& recorded = *reinterpret_cast<uint32_t*>(data - ORIGINAL_DATA_LEN_BEFORE_DATA);
+    if (recorded == 0) {
+        recorded = uint32_t(serialized_data_len(data) + 1);
+    }
+}
+
+} // namespace internal
+
 class AccountInfo {
-    template<uint64_t MAX_ACCOUNTS_EXPECTED>
-    friend bool deserialize(
-        const uint8_t* input,
-        AccountInfo (&account_infos)[MAX_ACCOUNTS_EXPECTED],
-        uint64_t& accounts_given,
-        const uint8_t* (&instruction_data),
-        uint64_t& instruction_data_len,
-        const Pubkey* (&program_id)
-    );
+    friend class AccountView;
+    friend class internal::AccountParser;
+    friend void internal::refresh_data_lens(const AccountInfo* account_infos, uint64_t count);
 
     Pubkey* _pubkey;      /** Public key of the account */
     Lamports* _lamports;  /** Number of lamports owned by this account */
-    uint64_t _data_len;   /** Length of data in bytes */
+    // mutable, as invocations take const AccountInfos, such as braced temporaries, whose lengths must be brought up
+    // to date beforehand (see refresh_data_lens), and the runtime writes the lengths back afterwards
+    mutable uint64_t _data_len;  /** Length of data in bytes, as passed to cross-program invocations */
     uint8_t* _data;       /** On-chain data within this account */
     Pubkey* _owner;       /** Program that owns this account */
     Epoch _rent_epoch;    /** The epoch at which this account will next owe rent */
@@ -50,8 +84,9 @@ public:
         return *_lamports;
     }
 
+    // read from the input, so that duplicates of the account see its length after a realloc
     const uint64_t& data_len() const {
-        return _data_len;
+        return internal::serialized_data_len(_data);
     }
 
     const uint8_t* data() const {
@@ -81,14 +116,51 @@ public:
     bool executable() const {
         return _executable;
     }
+
+    // transfers ownership, which the runtime permits for writable accounts owned by the program whose data is zeroed
+    void assign(const Pubkey& owner) {
+        *_owner = owner;
+    }
+
+    // resizes the data in place, up to MAX_PERMITTED_DATA_INCREASE bytes beyond its length at the start of the
+    // invocation. The runtime zeroes that space, so zero_init is only needed if the data shrank earlier in the
+    // invocation and the bytes it regains must not keep their old values.
+    uint64_t realloc(uint64_t new_len, bool zero_init) {
+        if (new_len > internal::original_data_len(_data) + MAX_PERMITTED_DATA_INCREASE) {
+            return error::INVALID_REALLOC;
+        }
+        const uint64_t old_len = data_len();
+        if (zero_init && new_len > old_len) {
+            memset(_data + old_len, 0, new_len - old_len);
+        }
+        internal::record_original_data_len(_data);
+        internal::serialized_data_len(_data) = new_len;
+        _data_len = new_len;
+        return SUCCESS;
+    }
 };
 
+namespace internal {
+
+// copies the data lengths from the input into the AccountInfos, which might not have been the ones resized, and
+// records the original lengths in case the invoked program resizes the accounts
+inline void refresh_data_lens(const AccountInfo* account_infos, uint64_t count) {
+    for (uint64_t i = 0; i != count; ++i) {
+        const AccountInfo& account = account_infos[i];
+        record_original_data_len(account._data);
+        account._data_len = serialized_data_len(account._data);
+    }
+}
+
+} // namespace internal
+
 struct AccountMeta {
     const Pubkey* pubkey;
     bool is_writable;
     bool is_signer;
 };
 
+// logs the account in detail, its data four bytes per syscall; log_data (see sol_event.h) logs the data with one
 inline void log(const AccountInfo& account) {
     log(account.pubkey());
     log("  - is_signer, is_writable, executable, lamports, rent_epoch");
@@ -106,4 +178,19 @@ inline void log(const AccountInfo& account) {
     }
 }
 
+// formats the pubkey, followed by the lamports, the data length and the flags that are set
+inline LogWriter& operator<<(LogWriter& writer, const AccountInfo& account) {
+    writer << account.pubkey() << " lamports: " << account.lamports() << " data_len: " << account.data_len();
+    if (account.is_signer()) {
+        writer << " signer";
+    }
+    if (account.is_writable()) {
+        writer << " writable";
+    }
+    if (account.executable()) {
+        writer << " executable";
+    }
+    return writer;
+}
+
 } // namespace sol
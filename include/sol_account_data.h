@@ -0,0 +1,144 @@
+#pragma once
+/**
+ * Typed, zero-copy access to account data
+ *
+ * AccountData<T> and AccountDataMut<T> overlay a T on an account's data instead of copying it. The data starts with an
+ * 8-byte discriminator identifying the type, followed by the T itself:
+ *
+ * struct Vault {
+ *     static constexpr uint64_t DISCRIMINATOR = account_discriminator("Vault");  // see sol_hash.h
+ *     Pubkey authority;
+ *     uint64_t balance;
+ * };
+ *
+ * Loading checks ownership, size, alignment and the discriminator in one go and returns SUCCESS or an error:
+ *
+ * AccountDataMut<Vault> vault;
+ * if (uint64_t error = vault.load(vault_account, program_id)) {
+ *     return error;
+ * }
+ * vault->balance += amount;
+ *
+ * A new account, whose data is all zeros, is claimed for a type by init() instead of load().
+ * Account data must be allocated with AccountData<T>::SPACE bytes at least.
+ *
+ * Accounts at program-derived addresses keep their canonical bump seed in a `uint8_t bump_seed` member of T, set from
+ * find_pda right after init(). Later instructions pass the loaded data to verify_pda_account(), which checks the address
+ * with a single hash rather than searching for the bump seed again:
+ *
+ * if (uint64_t error = verify_pda_account(vault_account, program_id, *vault, "vault", SignerSeed(vault->authority))) {
+ *     return error;
+ * }
+ */
+
+#include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_pubkey.h>
+#include <sol_seed.h>
+#include <sol_status_codes.h>
+#include <sol_syscall_wrappers.h>
+
+namespace sol {
+
+namespace internal {
+
+// returns SUCCESS if the account holds a T owned by the program, or an error otherwise
+template<class T, class ACCOUNT>
+uint64_t check_account_data(const ACCOUNT& account, const Pubkey& owner, bool initialized) {
+    static_assert(alignof(T) <= sizeof(uint64_t), "account data is only guaranteed to be 8-byte aligned");
+    static_assert(__is_trivially_copyable(T), "T is overlaid on the account data in place, without construction");
+    // zero-initialized accounts have a discriminator of 0, which thus marks them as uninitialized
+    static_assert(T::DISCRIMINATOR != 0, "T::DISCRIMINATOR must not be 0");
+    const uint64_t address = reinterpret_cast<uint64_t>(account.data());
+    const bool too_small = account.data_len() < sizeof(uint64_t) + sizeof(T);
+    uint64_t error = (account.owner() != owner) * error::INCORRECT_PROGRAM_ID;
+    error = first_nonzero(error, too_small * error::ACCOUNT_DATA_TOO_SMALL);
+    error = first_nonzero(error, ((address & (sizeof(uint64_t) - 1)) != 0) * error::INVALID_ACCOUNT_DATA);
+    if (error != SUCCESS) {
+        return error; // the discriminator can't be read safely
+    }
+    const uint64_t discriminator = *reinterpret_cast<const uint64_t*>(account.data());
+    if (initialized) {
+        return (discriminator != T::DISCRIMINATOR) * error::INVALID_ACCOUNT_DATA;
+    }
+    return (discriminator != 0) * error::ACCOUNT_ALREADY_INITIALIZED;
+}
+
+} // namespace internal
+
+// Read-only view of a T in an account's data
+template<class T>
+class AccountData {
+    const T* _data = nullptr;
+
+public:
+    // bytes of account data needed for the discriminator and a T
+    static constexpr uint64_t SPACE = sizeof(uint64_t) + sizeof(T);
+
+    // points to the account's T if it's valid, returning SUCCESS or an error
+    template<class ACCOUNT>
+    uint64_t load(const ACCOUNT& account, const Pubkey& owner) {
+        const uint64_t error = internal::check_account_data<T>(account, owner, true);
+        if (error == SUCCESS) {
+            _data = reinterpret_cast<const T*>(account.data() + sizeof(uint64_t));
+        }
+        return error;
+    }
+
+    const T& operator*() const {
+        return *_data;
+    }
+
+    const T* operator->() const {
+        return _data;
+    }
+};
+
+// Writable view of a T in an account's data
+template<class T>
+class AccountDataMut {
+    T* _data = nullptr;
+
+public:
+    static constexpr uint64_t SPACE = AccountData<T>::SPACE;
+
+    // points to the account's T if it's valid and the account is writable, returning SUCCESS or an error
+    template<class ACCOUNT>
+    uint64_t load(ACCOUNT& account, const Pubkey& owner) {
+        uint64_t error = internal::check_account_data<T>(account, owner, true);
+        error = internal::first_nonzero(error, !account.is_writable() * error::INVALID_ARGUMENT);
+        if (error == SUCCESS) {
+            _data = reinterpret_cast<T*>(account.data() + sizeof(uint64_t));
+        }
+        return error;
+    }
+
+    // claims a zero-initialized account for T by writing the discriminator, returning SUCCESS or an error
+    template<class ACCOUNT>
+    uint64_t init(ACCOUNT& account, const Pubkey& owner) {
+        uint64_t error = internal::check_account_data<T>(account, owner, false);
+        error = internal::first_nonzero(error, !account.is_writable() * error::INVALID_ARGUMENT);
+        if (error == SUCCESS) {
+            *reinterpret_cast<uint64_t*>(account.data()) = T::DISCRIMINATOR;
+            _data = reinterpret_cast<T*>(account.data() + sizeof(uint64_t));
+        }
+        return error;
+    }
+
+    T& operator*() const {
+        return *_data;
+    }
+
+    T* operator->() const {
+        return _data;
+    }
+};
+
+// returns SUCCESS if the account is the program derived address of the seeds and the bump seed stored in its data,
+// or error::INVALID_SEEDS otherwise
+template<class T, class ACCOUNT, class... Ts>
+uint64_t verify_pda_account(const ACCOUNT& account, const Pubkey& program_id, const T& data, const Ts&... seeds) {
+    return !verify_pda(account.pubkey(), program_id, data.bump_seed, seeds...) * error::INVALID_SEEDS;
+}
+
+} // namespace sol
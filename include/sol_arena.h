@@ -0,0 +1,193 @@
+#pragma once
+/**
+ * Bump allocation on the program heap
+ *
+ * An Arena hands out memory from a region by bumping an offset, without any syscalls. Memory is released all at once
+ * when the program exits, or by rolling back to a Scratch mark. Destructors are never run.
+ *
+ * Example:
+ * Arena arena;
+ * Pubkey* keys = arena.make_array<Pubkey>(accounts_given);
+ * {
+ *     Arena::Scratch scratch(arena);            // everything allocated from here on...
+ *     uint8_t* buffer = arena.make_array<uint8_t>(data_len);
+ *     // ...
+ * }                                             // ...is released here
+ *
+ * The default Arena covers the heap at HEAP_START, whose size is SOL_HEAP_SIZE bytes unless a program defines that
+ * macro before including the SDK, e.g. to match a larger heap frame requested for its transactions. Its last
+ * SYSVAR_CACHE_BYTES are left to the SysvarCache. (see sol_sysvar_cache.h)
+ * The Arena keeps its offset in the first 8 bytes of its region rather than in the object, since programs can't have
+ * mutable global variables. Any number of Arena objects for the same region may thus be created and share allocations.
+ * Don't mix the heap Arena with the sol_alloc_free_ syscall, which uses the same memory.
+ *
+ * Defining SOL_ARENA_GLOBAL_NEW in exactly one translation unit before including the SDK routes the global operator
+ * new to the heap Arena; operator delete is a no-op then.
+ */
+
+#include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_limits.h>
+#include <sol_logging.h>
+#include <sol_memory.h>
+#include <sol_syscall_wrappers.h>
+
+#ifndef SOL_HEAP_SIZE
+#define SOL_HEAP_SIZE ::sol::MIN_HEAP_FRAME_BYTES
+#endif
+
+#ifdef SOL_HOST
+// host builds have no fixed heap address, the region is provided by libsol_host (see host/sol_host.h)
+extern "C" sol::uint8_t sol_host_heap[];
+// tells libsol_host the SOL_HEAP_SIZE a translation unit was compiled with, which the emulated heap must cover
+extern "C" void sol_host_require_heap(sol::uint64_t size);
+#endif
+
+namespace sol {
+
+static_assert(SOL_HEAP_SIZE >= MIN_HEAP_FRAME_BYTES && SOL_HEAP_SIZE <= MAX_HEAP_FRAME_BYTES, "invalid SOL_HEAP_SIZE");
+static_assert(SOL_HEAP_SIZE % 1024 == 0, "SOL_HEAP_SIZE must be a multiple of 1 KB");
+
+// bytes at the end of the heap holding the SysvarCache, excluded from the default Arena
+constexpr uint64_t SYSVAR_CACHE_BYTES = 256;
+
+#ifdef SOL_HOST
+namespace internal {
+
+// registered by every translation unit before main(), as each may define a different SOL_HEAP_SIZE
+[[maybe_unused]] static const bool HOST_HEAP_REQUIRED = (sol_host_require_heap(SOL_HEAP_SIZE), true);
+
+} // namespace internal
+#endif
+
+// returns the start of the program heap
+inline uint8_t* heap_start() {
+#ifdef SOL_HOST
+    return sol_host_heap;
+#else
+    return reinterpret_cast<uint8_t*>(HEAP_START);
+#endif
+}
+
+class Arena {
+    static constexpr uint64_t HEADER = sizeof(uint64_t);  /** Bytes at the start of the region holding the offset */
+
+    uint8_t* _start;  /** Start of the region, which must be zero-initialized or only ever used by Arenas */
+    uint64_t _size;   /** Size of the region in bytes */
+
+    uint64_t& stored_offset() const {
+        return *reinterpret_cast<uint64_t*>(_start);
+    }
+
+public:
+    // an Arena over the program heap
+    Arena() : Arena(heap_start(), SOL_HEAP_SIZE - SYSVAR_CACHE_BYTES) {
+    }
+
+    // an Arena over the given region; it must be 8-byte aligned
+    Arena(void* start, uint64_t size) :
+        _start(static_cast<uint8_t*>(start)),
+        _size(size) {
+    }
+
+    // returns the offset of the next free byte
+    uint64_t offset() const {
+        const uint64_t offset = stored_offset();
+        return offset == 0 ? HEADER : offset; // zero-initialized memory is an empty Arena
+    }
+
+    uint64_t used() const {
+        return offset() - HEADER;
+    }
+
+    uint64_t available() const {
+        return _size - offset();
+    }
+
+    // returns uninitialized memory at an address divisible by the alignment, a power of two, or panics if there's not
+    // enough left
+    void* allocate(uint64_t bytes, uint64_t alignment = 8) {
+        // aligns the address rather than the offset, as the region itself may be less aligned
+        const uint64_t base = reinterpret_cast<uint64_t>(_start);
+        const uint64_t start = ((base + offset() + alignment - 1) & ~(alignment - 1)) - base;
+        if (start > _size || bytes > _size - start) {
+            log_error("ERROR: Arena exhausted, bytes requested:", bytes);
+            sol_panic();
+        }
+        stored_offset() = start + bytes;
+        return _start + start;
+    }
+
+    // constructs an object in the Arena
+    template<class T, class... Args>
+    T* make(Args&&... args) {
+        void* address = allocate(sizeof(T), alignof(T));
+        return new (address, internal::placement_tag()) T(internal::forward<Args>(args)...);
+    }
+
+    // constructs an array of value-initialized objects in the Arena
+    template<class T>
+    T* make_array(uint64_t count) {
+        if (count > UINT64_MAX / sizeof(T)) {
+            log_error("ERROR: Arena array too large, count:", count);
+            sol_panic();
+        }
+        T* array = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        for (uint64_t i = 0; i != count; ++i) {
+            new (&array[i], internal::placement_tag()) T();
+        }
+        return array;
+    }
+
+    // releases all allocations made after the given offset()
+    void rollback(uint64_t offset) {
+        if (offset < HEADER || offset > this->offset()) {
+            log_error("ERROR: Invalid Arena rollback");
+            sol_panic();
+        }
+        stored_offset() = offset;
+    }
+
+    // Releases the allocations made during its lifetime when going out of scope
+    class Scratch {
+        Arena& _arena;
+        uint64_t _offset;
+
+    public:
+        explicit Scratch(Arena& arena) :
+            _arena(arena),
+            _offset(arena.offset()) {
+        }
+
+        Scratch(const Scratch&) = delete;
+        Scratch& operator=(const Scratch&) = delete;
+
+        ~Scratch() {
+            _arena.rollback(_offset);
+        }
+    };
+};
+
+} // namespace sol
+
+#ifdef SOL_ARENA_GLOBAL_NEW
+void* operator new(sol::size_t bytes) {
+    return sol::Arena().allocate(bytes, 16);
+}
+
+void* operator new[](sol::size_t bytes) {
+    return sol::Arena().allocate(bytes, 16);
+}
+
+void operator delete(void*) noexcept {
+}
+
+void operator delete[](void*) noexcept {
+}
+
+void operator delete(void*, sol::size_t) noexcept {
+}
+
+void operator delete[](void*, sol::size_t) noexcept {
+}
+#endif
@@ -6,13 +6,26 @@
  * constexpr Pubkey clock_key = from_base58("SysvarC1ock11111111111111111111111111111111");
  *
  * It is the caller's responsibility to ensure the validity of the Base58 string.
+ *
+ * At run time, to_base58 encodes a public key or up to 64 bytes into a caller-provided buffer, e.g. for formatting log
+ * messages (see sol_log_line.h), and from_base58 decodes string arguments, checking the characters and the length:
+ *
+ * Pubkey recipient;
+ * if (!from_base58(argument, argument_len, recipient)) {
+ *     return error::INVALID_ARGUMENT;
+ * }
+ *
+ * Both work on 32-bit limbs, five Base58 digits at a time, rather than on single bytes and digits.
  */
 
 #include <sol_pubkey.h>
 
 namespace sol {
 
-//constexpr const char* map_to_base58 = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+constexpr char map_to_base58[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+// maximum length of a Base58-encoded public key
+constexpr uint64_t MAX_BASE58_PUBKEY_LEN = 44;
 constexpr int8_t map_from_base58[256] = {
     -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
     -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
@@ -57,4 +70,142 @@ constexpr Pubkey from_base58(const char* encoded) {
     return key;
 }
 
+// longest byte string encoded or decoded at run time, e.g. a signature
+constexpr uint64_t MAX_BASE58_DECODED_LEN = 64;
+
+// upper bound on the length of the Base58 encoding of len bytes, as log(256) / log(58) < 1.37
+constexpr uint64_t max_base58_len(uint64_t len) {
+    return len * 137 / 100 + 1;
+}
+
+// writes the Base58 encoding of at most MAX_BASE58_DECODED_LEN bytes without a terminating \0 and returns its length, or 0
+// if the encoding doesn't fit into the capacity
+inline uint64_t to_base58(const uint8_t* bytes, uint64_t len, char* encoded, uint64_t capacity) {
+    constexpr uint32_t CHUNK = 58 * 58 * 58 * 58 * 58; // the most digits whose remainder fits into 32 bits
+    constexpr uint64_t MAX_LIMBS = MAX_BASE58_DECODED_LEN / 4;
+    if (len > MAX_BASE58_DECODED_LEN) {
+        return 0;
+    }
+
+    // the bytes as a big-endian number of 32-bit limbs, divided by CHUNK repeatedly for 5 digits at a time
+    uint32_t limbs[MAX_LIMBS];
+    const uint64_t limbs_len = (len + 3) / 4;
+    for (uint64_t i = 0; i != limbs_len; ++i) {
+        limbs[i] = 0;
+    }
+    for (uint64_t i = 0; i != len; ++i) {
+        const uint64_t position = len - 1 - i; // in bytes from the least significant end
+        limbs[limbs_len - 1 - position / 4] |= uint32_t(bytes[i]) << (8 * (position % 4));
+    }
+    char digits[max_base58_len(MAX_BASE58_DECODED_LEN) + 5];
+    uint64_t start = sizeof(digits);
+    uint64_t first = 0;
+    while (first != limbs_len && limbs[first] == 0) {
+        ++first;
+    }
+    while (first != limbs_len) {
+        uint64_t remainder = 0;
+        for (uint64_t i = first; i != limbs_len; ++i) {
+            const uint64_t current = remainder << 32 | limbs[i];
+            limbs[i] = uint32_t(current / CHUNK);
+            remainder = current % CHUNK;
+        }
+        for (int i = 0; i != 5; ++i) {
+            digits[--start] = char(remainder % 58);
+            remainder /= 58;
+        }
+        while (first != limbs_len && limbs[first] == 0) {
+            ++first;
+        }
+    }
+    while (start != sizeof(digits) && digits[start] == 0) {
+        ++start;
+    }
+
+    // every leading zero byte is encoded as a '1'
+    uint64_t zeros = 0;
+    while (zeros != len && bytes[zeros] == 0) {
+        ++zeros;
+    }
+    if (zeros + sizeof(digits) - start > capacity) {
+        return 0;
+    }
+    uint64_t encoded_len = 0;
+    for (uint64_t i = 0; i != zeros; ++i) {
+        encoded[encoded_len++] = map_to_base58[0];
+    }
+    for (uint64_t i = start; i != sizeof(digits); ++i) {
+        encoded[encoded_len++] = map_to_base58[int(digits[i])];
+    }
+    return encoded_len;
+}
+
+// writes the Base58 encoding of the key without a terminating \0 and returns its length
+inline uint64_t to_base58(const Pubkey& key, char (&encoded)[MAX_BASE58_PUBKEY_LEN]) {
+    return to_base58(reinterpret_cast<const uint8_t*>(&key), sizeof(Pubkey), encoded, MAX_BASE58_PUBKEY_LEN);
+}
+
+// decodes len Base58 characters into the buffer and stores the number of bytes in decoded_len, returning false for
+// invalid characters and results that exceed the capacity or MAX_BASE58_DECODED_LEN
+inline bool from_base58(const char* encoded, uint64_t len, uint8_t* decoded, uint64_t capacity, uint64_t& decoded_len) {
+    constexpr uint64_t MAX_LIMBS = MAX_BASE58_DECODED_LEN / 4;
+
+    // every leading '1' is decoded as a zero byte
+    uint64_t zeros = 0;
+    while (zeros != len && encoded[zeros] == map_to_base58[0]) {
+        ++zeros;
+    }
+
+    // the number as little-endian 32-bit limbs, multiplied by 58^5 for up to 5 digits at a time
+    uint32_t limbs[MAX_LIMBS];
+    uint64_t limbs_len = 0;
+    for (uint64_t i = zeros; i < len; i += 5) {
+        uint32_t multiplier = 1;
+        uint64_t chunk = 0;
+        for (uint64_t j = i; j != len && j != i + 5; ++j) {
+            const int8_t digit = map_from_base58[uint8_t(encoded[j])];
+            if (digit < 0) {
+                return false;
+            }
+            chunk = chunk * 58 + uint64_t(digit);
+            multiplier *= 58;
+        }
+        for (uint64_t k = 0; k != limbs_len; ++k) {
+            chunk += uint64_t(limbs[k]) * multiplier;
+            limbs[k] = uint32_t(chunk);
+            chunk >>= 32;
+        }
+        if (chunk != 0) {
+            if (limbs_len == MAX_LIMBS) {
+                return false;
+            }
+            limbs[limbs_len++] = uint32_t(chunk);
+        }
+    }
+
+    uint64_t significant = 4 * limbs_len;
+    while (significant != 0 && (limbs[(significant - 1) / 4] >> (8 * ((significant - 1) % 4)) & 0xff) == 0) {
+        --significant;
+    }
+    if (zeros + significant > capacity || zeros + significant > MAX_BASE58_DECODED_LEN) {
+        return false;
+    }
+    for (uint64_t i = 0; i != zeros; ++i) {
+        decoded[i] = 0;
+    }
+    for (uint64_t i = 0; i != significant; ++i) {
+        const uint64_t position = significant - 1 - i;
+        decoded[zeros + i] = uint8_t(limbs[position / 4] >> (8 * (position % 4)));
+    }
+    decoded_len = zeros + significant;
+    return true;
+}
+
+// decodes a Base58-encoded public key at run time, returning false unless it's valid and exactly 32 bytes long
+inline bool from_base58(const char* encoded, uint64_t len, Pubkey& key) {
+    uint64_t decoded_len = 0;
+    return from_base58(encoded, len, reinterpret_cast<uint8_t*>(&key), sizeof(Pubkey), decoded_len) &&
+           decoded_len == sizeof(Pubkey);
+}
+
 } // namespace sol
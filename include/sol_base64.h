@@ -0,0 +1,49 @@
+#pragma once
+/**
+ * Run-time Base64 encoding (RFC 4648, with padding) into a caller-provided buffer
+ *
+ * Example:
+ * char encoded[base64_len(sizeof(payload))];
+ * const uint64_t len = to_base64(payload, sizeof(payload), encoded, sizeof(encoded));
+ *
+ * Binary events logged by sol_log_data are encoded by the runtime itself (see sol_event.h).
+ */
+
+#include <sol_int.h>
+
+namespace sol {
+
+constexpr char map_to_base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// length of the Base64 encoding of len bytes
+constexpr uint64_t base64_len(uint64_t len) {
+    return (len + 2) / 3 * 4;
+}
+
+// writes the Base64 encoding of the bytes without a terminating \0 and returns its length, or 0 if it doesn't fit
+inline uint64_t to_base64(const uint8_t* bytes, uint64_t len, char* encoded, uint64_t capacity) {
+    if (base64_len(len) > capacity) {
+        return 0;
+    }
+    uint64_t i = 0;
+    char* out = encoded;
+    for (; i + 3 <= len; i += 3) {
+        const uint32_t group = uint32_t(bytes[i]) << 16 | uint32_t(bytes[i + 1]) << 8 | bytes[i + 2];
+        out[0] = map_to_base64[group >> 18];
+        out[1] = map_to_base64[group >> 12 & 63];
+        out[2] = map_to_base64[group >> 6 & 63];
+        out[3] = map_to_base64[group & 63];
+        out += 4;
+    }
+    if (i != len) {
+        const uint32_t group = uint32_t(bytes[i]) << 16 | (i + 1 != len ? uint32_t(bytes[i + 1]) << 8 : 0);
+        out[0] = map_to_base64[group >> 18];
+        out[1] = map_to_base64[group >> 12 & 63];
+        out[2] = i + 1 != len ? map_to_base64[group >> 6 & 63] : '=';
+        out[3] = '=';
+        out += 4;
+    }
+    return uint64_t(out - encoded);
+}
+
+} // namespace sol
@@ -0,0 +1,329 @@
+#pragma once
+/**
+ * Borsh encoding and decoding without allocations (see https://borsh.io)
+ *
+ * Structs list their fields in order via BorshFields, after which they can be read from instruction data or account
+ * data and written to account data or a stack buffer:
+ *
+ * struct Deposit {
+ *     uint64_t amount;
+ *     Pubkey recipient;
+ *     uint8_t memo[16];
+ *     using borsh_fields = BorshFields<&Deposit::amount, &Deposit::recipient, &Deposit::memo>;
+ * };
+ *
+ * Deposit deposit;
+ * if (uint64_t error = borsh_decode(instruction_data, instruction_data_len, deposit)) {
+ *     return error;
+ * }
+ *
+ * Supported are integers, bool, Pubkey, Lamports, Epoch, Slot, fixed-size arrays ([T; N] in Rust), BorshBytes for
+ * Vec<u8> and String, and structs of these. When all fields of a struct have a fixed size, the size is known at compile
+ * time and reading or writing it takes a single bounds check. BorshBytes reference the encoded bytes rather than
+ * copying them. Other Vec<T> can be read by read_length() followed by as many reads of a T; enums by reading the
+ * variant index as uint8_t first.
+ *
+ * BorshReader and BorshWriter remember the first failure, so a sequence of reads or writes is checked once at the end.
+ */
+
+#include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_memory.h>
+#include <sol_pubkey.h>
+#include <sol_status_codes.h>
+
+namespace sol {
+
+class BorshReader;
+class BorshWriter;
+
+// Lists the members of a struct in the order of their Borsh encoding
+template<auto... MEMBERS>
+struct BorshFields {};
+
+// References the bytes of a Vec<u8> or String, without the length prefix
+struct BorshBytes {
+    const uint8_t* data = nullptr;
+    uint32_t len = 0;
+};
+
+// Traits describing the encoding of T:
+// FIXED tells whether all encodings of T have the same SIZE. Fixed types provide unchecked decode() and encode().
+// All types provide read() and write(), which check bounds.
+template<class T, class ENABLE = void>
+struct BorshTraits;
+
+namespace internal {
+
+// types whose Borsh encoding is their memory representation, as integers are little-endian like the BPF target
+template<class T> struct is_borsh_verbatim { static constexpr bool value = is_integer<T>::value; };
+template<> struct is_borsh_verbatim<Lamports> { static constexpr bool value = true; };
+template<> struct is_borsh_verbatim<Epoch> { static constexpr bool value = true; };
+template<> struct is_borsh_verbatim<Slot> { static constexpr bool value = true; };
+template<> struct is_borsh_verbatim<Pubkey> { static constexpr bool value = true; }; // 32 bytes, copied verbatim
+
+template<class M> struct member_pointer;
+template<class C, class F> struct member_pointer<F C::*> { typedef F type; };
+
+} // namespace internal
+
+class BorshReader {
+    const uint8_t* _data;  /** Next byte to be read */
+    const uint8_t* _end;   /** End of the encoded bytes */
+    bool _ok;              /** No read has failed so far */
+
+public:
+    BorshReader(const uint8_t* data, uint64_t len) :
+        _data(data),
+        _end(data + len),
+        _ok(true) {
+    }
+
+    // returns whether all reads have succeeded
+    bool ok() const {
+        return _ok;
+    }
+
+    uint64_t remaining() const {
+        return _end - _data;
+    }
+
+    // returns a pointer to the next bytes and advances past them, or nullptr if fewer remain (or a read failed)
+    const uint8_t* take(uint64_t bytes) {
+        if (!_ok || bytes > remaining()) {
+            _ok = false;
+            return nullptr;
+        }
+        const uint8_t* data = _data;
+        _data += bytes;
+        return data;
+    }
+
+    // reads a value, returning whether all reads have succeeded so far
+    template<class T>
+    bool read(T& value) {
+        typedef BorshTraits<T> Traits;
+        if constexpr (Traits::FIXED) {
+            const uint8_t* data = take(Traits::SIZE);
+            if (data != nullptr && !Traits::decode(data, value)) {
+                _ok = false;
+            }
+        } else {
+            Traits::read(*this, value);
+        }
+        return _ok;
+    }
+
+    // reads the u32 length prefix of a Vec<T>
+    uint32_t read_length() {
+        uint32_t len = 0;
+        read(len);
+        return len;
+    }
+
+    void fail() {
+        _ok = false;
+    }
+};
+
+class BorshWriter {
+    uint8_t* _data;   /** Next byte to be written */
+    uint8_t* _start;  /** Start of the buffer */
+    uint8_t* _end;    /** End of the buffer */
+    bool _ok;         /** No write has failed so far */
+
+public:
+    BorshWriter(uint8_t* buffer, uint64_t capacity) :
+        _data(buffer),
+        _start(buffer),
+        _end(buffer + capacity),
+        _ok(true) {
+    }
+
+    template<uint64_t CAPACITY>
+    explicit BorshWriter(uint8_t (&buffer)[CAPACITY]) : BorshWriter(buffer, CAPACITY) {
+    }
+
+    // returns whether all writes have succeeded
+    bool ok() const {
+        return _ok;
+    }
+
+    // returns the number of bytes written
+    uint64_t size() const {
+        return _data - _start;
+    }
+
+    const uint8_t* data() const {
+        return _start;
+    }
+
+    // returns a pointer to the next bytes and advances past them, or nullptr if they don't fit (or a write failed)
+    uint8_t* take(uint64_t bytes) {
+        if (!_ok || bytes > uint64_t(_end - _data)) {
+            _ok = false;
+            return nullptr;
+        }
+        uint8_t* data = _data;
+        _data += bytes;
+        return data;
+    }
+
+    // writes a value, returning whether all writes have succeeded so far
+    template<class T>
+    bool write(const T& value) {
+        typedef BorshTraits<T> Traits;
+        if constexpr (Traits::FIXED) {
+            uint8_t* data = take(Traits::SIZE);
+            if (data != nullptr) {
+                Traits::encode(data, value);
+            }
+        } else {
+            Traits::write(*this, value);
+        }
+        return _ok;
+    }
+};
+
+// Integers, the types wrapping them and Pubkeys are copied verbatim
+template<class T>
+struct BorshTraits<T, typename internal::enable_if<internal::is_borsh_verbatim<T>::value>::type> {
+    static constexpr bool FIXED = true;
+    static constexpr uint64_t SIZE = sizeof(T);
+
+    static bool decode(const uint8_t* data, T& value) {
+        __builtin_memcpy(&value, data, SIZE);
+        return true;
+    }
+
+    static void encode(uint8_t* data, const T& value) {
+        __builtin_memcpy(data, &value, SIZE);
+    }
+};
+
+template<>
+struct BorshTraits<bool> {
+    static constexpr bool FIXED = true;
+    static constexpr uint64_t SIZE = 1;
+
+    // only 0 and 1 are valid encodings
+    static bool decode(const uint8_t* data, bool& value) {
+        value = data[0] != 0;
+        return data[0] <= 1;
+    }
+
+    static void encode(uint8_t* data, const bool& value) {
+        data[0] = value ? 1 : 0;
+    }
+};
+
+template<class T, uint64_t N>
+struct BorshTraits<T[N]> {
+    typedef BorshTraits<T> Element;
+    static constexpr bool FIXED = Element::FIXED;
+    static constexpr uint64_t SIZE = N * Element::SIZE;
+
+    static bool decode(const uint8_t* data, T (&value)[N]) {
+        bool valid = true;
+        for (uint64_t i = 0; i != N; ++i) {
+            valid &= Element::decode(data + i * Element::SIZE, value[i]);
+        }
+        return valid;
+    }
+
+    static void encode(uint8_t* data, const T (&value)[N]) {
+        for (uint64_t i = 0; i != N; ++i) {
+            Element::encode(data + i * Element::SIZE, value[i]);
+        }
+    }
+
+    static void read(BorshReader& reader, T (&value)[N]) {
+        for (uint64_t i = 0; i != N; ++i) {
+            reader.read(value[i]);
+        }
+    }
+
+    static void write(BorshWriter& writer, const T (&value)[N]) {
+        for (uint64_t i = 0; i != N; ++i) {
+            writer.write(value[i]);
+        }
+    }
+};
+
+template<>
+struct BorshTraits<BorshBytes> {
+    static constexpr bool FIXED = false;
+    static constexpr uint64_t SIZE = sizeof(uint32_t); // at least the length prefix
+
+    static void read(BorshReader& reader, BorshBytes& value) {
+        const uint32_t len = reader.read_length();
+        value.data = reader.take(len);
+        value.len = value.data != nullptr ? len : 0;
+    }
+
+    static void write(BorshWriter& writer, const BorshBytes& value) {
+        if (writer.write(value.len)) {
+            uint8_t* data = writer.take(value.len);
+            if (data != nullptr && value.len != 0) {
+                memcpy(data, value.data, value.len);
+            }
+        }
+    }
+};
+
+namespace internal {
+
+template<class T, class FIELDS>
+struct BorshStruct;
+
+template<class T, auto... MEMBERS>
+struct BorshStruct<T, BorshFields<MEMBERS...>> {
+    template<auto MEMBER>
+    using Field = BorshTraits<typename member_pointer<decltype(MEMBER)>::type>;
+
+    static constexpr bool FIXED = (Field<MEMBERS>::FIXED && ...);
+    static constexpr uint64_t SIZE = (Field<MEMBERS>::SIZE + ... + 0);
+
+    static bool decode(const uint8_t* data, T& value) {
+        bool valid = true;
+        uint64_t offset = 0;
+        ((valid &= Field<MEMBERS>::decode(data + offset, value.*MEMBERS), offset += Field<MEMBERS>::SIZE), ...);
+        return valid;
+    }
+
+    static void encode(uint8_t* data, const T& value) {
+        uint64_t offset = 0;
+        ((Field<MEMBERS>::encode(data + offset, value.*MEMBERS), offset += Field<MEMBERS>::SIZE), ...);
+    }
+
+    static void read(BorshReader& reader, T& value) {
+        (reader.read(value.*MEMBERS), ...);
+    }
+
+    static void write(BorshWriter& writer, const T& value) {
+        (writer.write(value.*MEMBERS), ...);
+    }
+};
+
+} // namespace internal
+
+template<class T>
+struct BorshTraits<T, internal::void_t<typename T::borsh_fields>> : internal::BorshStruct<T, typename T::borsh_fields> {
+};
+
+// decodes a T from all of the bytes, returning SUCCESS or error::INVALID_INSTRUCTION_DATA
+// like Rust's try_from_slice, bytes left over after the T are an error rather than ignored
+template<class T>
+uint64_t borsh_decode(const uint8_t* data, uint64_t len, T& value) {
+    BorshReader reader(data, len);
+    return reader.read(value) && reader.remaining() == 0 ? SUCCESS : error::INVALID_INSTRUCTION_DATA;
+}
+
+// encodes a T at the start of the buffer, returning the number of bytes written or 0 if it doesn't fit
+template<class T>
+uint64_t borsh_encode(uint8_t* buffer, uint64_t capacity, const T& value) {
+    BorshWriter writer(buffer, capacity);
+    return writer.write(value) ? writer.size() : 0;
+}
+
+} // namespace sol
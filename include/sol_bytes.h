@@ -1,9 +1,14 @@
 #pragma once
 /**
  * A structure for passing bytes to the sol_keccak256 and sol_sha256 hash functions (see sol_syscalls.h)
+ *
+ * The sha256 and keccak256 functions build arrays of Bytes from their arguments (see sol_hash.h), as does log_data.
+ * (see sol_event.h)
  */
 
 #include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_string.h>
 
 namespace sol {
 
@@ -12,4 +17,34 @@ struct Bytes {
     uint64_t len;
 };
 
+namespace internal {
+
+// the underlying bytes of an object
+template<class T>
+Bytes to_bytes(const T& object) {
+    static_assert(!is_pointer<T>::value, "the bytes of an address are almost certainly not intended");
+    return {reinterpret_cast<const uint8_t*>(&object), sizeof(object)};
+}
+
+template<class T, uint64_t N>
+Bytes to_bytes(const T (&array)[N]) {
+    return {reinterpret_cast<const uint8_t*>(array), sizeof(array)};
+}
+
+// a string without the trailing \0 character
+inline Bytes to_bytes(const char* string) {
+    return {reinterpret_cast<const uint8_t*>(string), strlen(string)};
+}
+
+template<uint64_t N>
+Bytes to_bytes(const char (&string)[N]) {
+    return to_bytes(static_cast<const char*>(string));
+}
+
+inline Bytes to_bytes(const Bytes& bytes) {
+    return bytes;
+}
+
+} // namespace internal
+
 } // namespace sol
@@ -0,0 +1,351 @@
+#pragma once
+/**
+ * Generating a program's entrypoint that routes instructions to handlers by discriminator
+ *
+ * SOL_ENTRYPOINT defines the extern "C" entrypoint for a list of handlers, each registered with its discriminator:
+ * Tag<T, f> for instructions whose data starts with the byte T, or Sighash<S, f> for an 8-byte discriminator S such as
+ * Anchor's sha256("global:<name>")[..8]. All handlers of a program use the same kind of discriminator.
+ *
+ * Example:
+ * using DepositAccounts = Accounts<Writable<Signer>, Writable<Owner<MyProgram>>>;
+ *
+ * uint64_t deposit(DepositAccounts& accounts, const uint64_t& amount) { ... }
+ * uint64_t withdraw(const InstructionContext& context, DepositAccounts& accounts, const Withdrawal& withdrawal) { ... }
+ *
+ * SOL_ENTRYPOINT(
+ *     Sighash<instruction_discriminator("deposit"), deposit>,
+ *     Sighash<instruction_discriminator("withdraw"), withdraw>
+ * )
+ *
+ * The entrypoint deserializes the accounts onto the heap (see sol_serialization.h) and reads the discriminator. Handlers
+ * are found in a table built at compile time, indexed directly by the tag, or by a perfect hash of the sighash whose
+ * multiplier the compiler searches for. Dispatch thus takes the same few instructions for any number of handlers, where
+ * a chain of comparisons would grow with each one. Should none of SOL_PERFECT_HASH_ATTEMPTS multipliers (4096 by
+ * default) separate the sighashes, they're sorted instead and found by binary search.
+ *
+ * The parameters of a handler determine what it's passed, in order:
+ * - const InstructionContext& for the program id, all AccountInfos and the instruction data after the discriminator
+ * - Accounts<Cs...>& for the accounts, loaded and checked against their constraints (see sol_schema.h)
+ * - const T& or T for anything else, decoded from the instruction data in the Borsh format (see sol_borsh.h)
+ * The first failure is returned without calling the handler, as is error::INVALID_INSTRUCTION_DATA for instruction data
+ * without a registered discriminator.
+ */
+
+#include <sol_account.h>
+#include <sol_borsh.h>
+#include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_logging.h>
+#include <sol_pubkey.h>
+#include <sol_schema.h>
+#include <sol_serialization.h>
+#include <sol_status_codes.h>
+
+#ifndef SOL_PERFECT_HASH_ATTEMPTS
+#define SOL_PERFECT_HASH_ATTEMPTS 4096
+#endif
+
+namespace sol {
+
+// What a handler may ask for besides its decoded accounts and arguments
+struct InstructionContext {
+    const Pubkey& program_id;
+    AccountInfo* account_infos;  /** All accounts given, deserialized */
+    uint64_t accounts_given;
+    const uint8_t* data;         /** Instruction data following the discriminator */
+    uint64_t data_len;
+};
+
+namespace internal {
+
+// Produces a handler's parameter of type P
+template<class P>
+struct HandlerParameter {
+    typename remove_cvref<P>::type value;
+
+    uint64_t load(const InstructionContext&, BorshReader& reader) {
+        return reader.read(value) ? SUCCESS : error::INVALID_INSTRUCTION_DATA;
+    }
+
+    const typename remove_cvref<P>::type& get() const {
+        return value;
+    }
+};
+
+template<>
+struct HandlerParameter<const InstructionContext&> {
+    const InstructionContext* context;
+
+    uint64_t load(const InstructionContext& context, BorshReader&) {
+        this->context = &context;
+        return SUCCESS;
+    }
+
+    const InstructionContext& get() const {
+        return *context;
+    }
+};
+
+template<class... Cs>
+struct HandlerParameter<Accounts<Cs...>&> {
+    Accounts<Cs...> accounts;
+
+    uint64_t load(const InstructionContext& context, BorshReader&) {
+        return accounts.load(context.account_infos, context.accounts_given);
+    }
+
+    Accounts<Cs...>& get() {
+        return accounts;
+    }
+};
+
+// loads the parameters Ps one after another, then calls the handler with all of them
+template<class... Ps>
+struct HandlerParameters;
+
+template<>
+struct HandlerParameters<> {
+    template<class F, class... Loaded>
+    static uint64_t call(F handler, const InstructionContext&, BorshReader&, Loaded&... loaded) {
+        return handler(loaded.get()...);
+    }
+};
+
+template<class P, class... Ps>
+struct HandlerParameters<P, Ps...> {
+    template<class F, class... Loaded>
+    static uint64_t call(F handler, const InstructionContext& context, BorshReader& reader, Loaded&... loaded) {
+        HandlerParameter<P> parameter;
+        if (const uint64_t error = parameter.load(context, reader)) {
+            return error;
+        }
+        return HandlerParameters<Ps...>::call(handler, context, reader, loaded..., parameter);
+    }
+};
+
+template<class F>
+struct HandlerSignature;
+
+template<class... Ps>
+struct HandlerSignature<uint64_t (*)(Ps...)> {
+    typedef HandlerParameters<Ps...> Parameters;
+};
+
+template<auto HANDLER>
+uint64_t call_handler(const InstructionContext& context) {
+    BorshReader reader(context.data, context.data_len);
+    return HandlerSignature<decltype(HANDLER)>::Parameters::call(HANDLER, context, reader);
+}
+
+typedef uint64_t (*HandlerThunk)(const InstructionContext& context);
+
+constexpr uint64_t PERFECT_HASH_ATTEMPTS = SOL_PERFECT_HASH_ATTEMPTS;
+
+// A multiplicative hash mapping each discriminator to its own slot of a table of 2^bits entries
+struct PerfectHash {
+    uint64_t multiplier;
+    uint64_t bits;
+
+    constexpr uint64_t slot(uint64_t discriminator) const {
+        return (discriminator * multiplier) >> (64 - bits);
+    }
+};
+
+// the bits of the smallest table with a slot per discriminator
+constexpr uint64_t min_table_bits(uint64_t discriminators) {
+    uint64_t bits = 1;
+    while ((uint64_t(1) << bits) < discriminators) {
+        ++bits;
+    }
+    return bits;
+}
+
+// searches for a multiplier without collisions, in tables of up to 8 times as many slots as discriminators; each
+// attempt marks the slots taken in a bitmap, so it takes a single pass over the discriminators
+template<uint64_t N>
+constexpr PerfectHash find_perfect_hash(const uint64_t (&discriminators)[N]) {
+    constexpr uint64_t MAX_BITS = min_table_bits(N) + 3;
+    for (uint64_t bits = min_table_bits(N); bits <= MAX_BITS; ++bits) {
+        // a random multiplier avoids collisions with a probability of about e^(-N(N-1)/2^(bits+1)); below e^-8, the
+        // attempts would rarely succeed and only cost compile time
+        if (N * (N - 1) > (uint64_t(16) << bits)) {
+            continue;
+        }
+        uint64_t multiplier = 0x9e3779b97f4a7c15; // 2^64 / golden ratio
+        for (uint64_t attempt = 0; attempt != PERFECT_HASH_ATTEMPTS; ++attempt) {
+            const PerfectHash hash = {multiplier, bits};
+            uint64_t taken[((uint64_t(1) << MAX_BITS) + 63) / 64] = {};
+            bool collision = false;
+            for (uint64_t i = 0; i != N && !collision; ++i) {
+                const uint64_t slot = hash.slot(discriminators[i]);
+                const uint64_t bit = uint64_t(1) << (slot % 64);
+                collision = (taken[slot / 64] & bit) != 0;
+                taken[slot / 64] |= bit;
+            }
+            if (!collision) {
+                return hash;
+            }
+            multiplier = (multiplier * 6364136223846793005 + 1442695040888963407) | 1; // next odd candidate
+        }
+    }
+    return {0, 0};
+}
+
+template<uint64_t N>
+constexpr bool all_distinct(const uint64_t (&values)[N]) {
+    for (uint64_t i = 0; i != N; ++i) {
+        for (uint64_t j = 0; j != i; ++j) {
+            if (values[i] == values[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace internal
+
+// Routes instructions whose data starts with the byte TAG to HANDLER
+template<uint8_t TAG, auto HANDLER>
+struct Tag {
+    static constexpr uint64_t DISCRIMINATOR = TAG;
+    static constexpr uint64_t DISCRIMINATOR_LEN = 1;
+    static constexpr internal::HandlerThunk THUNK = &internal::call_handler<HANDLER>;
+};
+
+// Routes instructions whose data starts with the little-endian 8 bytes of SIGHASH to HANDLER
+template<uint64_t SIGHASH, auto HANDLER>
+struct Sighash {
+    static constexpr uint64_t DISCRIMINATOR = SIGHASH;
+    static constexpr uint64_t DISCRIMINATOR_LEN = 8;
+    static constexpr internal::HandlerThunk THUNK = &internal::call_handler<HANDLER>;
+};
+
+// Finds the handler of an instruction in a table built at compile time
+template<class H, class... Hs>
+class Dispatcher {
+    static constexpr uint64_t DISCRIMINATOR_LEN = H::DISCRIMINATOR_LEN;
+    static_assert(((Hs::DISCRIMINATOR_LEN == DISCRIMINATOR_LEN) && ...), "handlers must not mix Tag and Sighash");
+
+    static constexpr uint64_t DISCRIMINATORS[] = {H::DISCRIMINATOR, Hs::DISCRIMINATOR...};
+    static_assert(internal::all_distinct(DISCRIMINATORS), "a discriminator is registered more than once");
+
+    static constexpr internal::PerfectHash HASH = DISCRIMINATOR_LEN == 8 ?
+        internal::find_perfect_hash(DISCRIMINATORS) :
+        internal::PerfectHash{0, 0};
+
+public:
+    // whether sighashes are looked up by binary search in a sorted table, as no perfect hash was found for them
+    static constexpr bool BINARY_SEARCH = DISCRIMINATOR_LEN == 8 && HASH.bits == 0;
+
+private:
+
+    // tags index the table directly
+    static constexpr uint64_t max_tag() {
+        uint64_t max = 0;
+        for (const uint64_t discriminator : DISCRIMINATORS) {
+            max = discriminator > max ? discriminator : max;
+        }
+        return max;
+    }
+
+    static constexpr uint64_t TABLE_SIZE =
+        DISCRIMINATOR_LEN == 1 ? max_tag() + 1 : BINARY_SEARCH ? 1 + sizeof...(Hs) : uint64_t(1) << HASH.bits;
+
+    struct Entry {
+        uint64_t discriminator;
+        internal::HandlerThunk thunk;
+    };
+
+    struct Table {
+        Entry entries[TABLE_SIZE];
+    };
+
+    static constexpr uint64_t slot(uint64_t discriminator) {
+        return DISCRIMINATOR_LEN == 1 ? discriminator : HASH.slot(discriminator);
+    }
+
+    static constexpr Table make_table() {
+        Table table = {};
+        if constexpr (BINARY_SEARCH) {
+            const Entry entries[] = {{H::DISCRIMINATOR, H::THUNK}, {Hs::DISCRIMINATOR, Hs::THUNK}...};
+            for (uint64_t i = 0; i != TABLE_SIZE; ++i) { // insertion sort by discriminator
+                uint64_t j = i;
+                for (; j != 0 && table.entries[j - 1].discriminator > entries[i].discriminator; --j) {
+                    table.entries[j] = table.entries[j - 1];
+                }
+                table.entries[j] = entries[i];
+            }
+        } else {
+            ((table.entries[slot(H::DISCRIMINATOR)] = {H::DISCRIMINATOR, H::THUNK}), ...,
+             (table.entries[slot(Hs::DISCRIMINATOR)] = {Hs::DISCRIMINATOR, Hs::THUNK}));
+        }
+        return table;
+    }
+
+    static constexpr Table TABLE = make_table();
+
+    // returns the index of the discriminator's entry if it has one, otherwise any other index
+    static uint64_t find(uint64_t discriminator) {
+        if constexpr (BINARY_SEARCH) {
+            uint64_t low = 0;
+            uint64_t high = TABLE_SIZE;
+            while (low != high) {
+                const uint64_t middle = (low + high) / 2;
+                if (TABLE.entries[middle].discriminator < discriminator) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            return low;
+        } else {
+            return slot(discriminator);
+        }
+    }
+
+public:
+    // deserializes the input and calls the handler of the instruction's discriminator
+    static uint64_t dispatch(const uint8_t* input) {
+        AccountInfo* account_infos = nullptr;
+        uint64_t accounts_given = 0;
+        const uint8_t* data = nullptr;
+        uint64_t data_len = 0;
+        const Pubkey* program_id = nullptr;
+        if (!deserialize(input, account_infos, accounts_given, data, data_len, program_id)) {
+            return error::INVALID_ARGUMENT;
+        }
+
+        if (data_len < DISCRIMINATOR_LEN) {
+            log_error("ERROR: Instruction data lacks a discriminator");
+            return error::INVALID_INSTRUCTION_DATA;
+        }
+        uint64_t discriminator = data[0];
+        if constexpr (DISCRIMINATOR_LEN == 8) {
+            __builtin_memcpy(&discriminator, data, 8);
+        }
+        const uint64_t index = find(discriminator);
+        if (index >= TABLE_SIZE || TABLE.entries[index].thunk == nullptr ||
+            TABLE.entries[index].discriminator != discriminator) {
+            log_error("ERROR: Unknown instruction", discriminator);
+            return error::INVALID_INSTRUCTION_DATA;
+        }
+
+        const InstructionContext context = {
+            *program_id,
+            account_infos,
+            accounts_given,
+            data + DISCRIMINATOR_LEN,
+            data_len - DISCRIMINATOR_LEN
+        };
+        return TABLE.entries[index].thunk(context);
+    }
+};
+
+} // namespace sol
+
+// defines the program's entrypoint, dispatching to the given Tag or Sighash handlers (see sol_entrypoint.h)
+#define SOL_ENTRYPOINT(...)                                                 \
+    extern "C" ::sol::uint64_t entrypoint(const ::sol::uint8_t* input) {    \
+        return ::sol::Dispatcher<__VA_ARGS__>::dispatch(input);             \
+    }
@@ -0,0 +1,120 @@
+#pragma once
+/**
+ * Binary events, logged with a single syscall each
+ *
+ * log_data() passes any number of byte fields to the sol_log_data syscall, which the runtime logs as one message of the
+ * form "Program data: <base64> <base64> ...". Unlike text logs, the data is neither formatted nor split into several
+ * syscalls, and its cost grows by one compute unit per byte:
+ *
+ * log_data(account.pubkey(), Bytes{account.data(), account.data_len()});
+ *
+ * emit_event() logs a typed event as one field in the format of Anchor's emit!, i.e. its 8-byte DISCRIMINATOR followed
+ * by its Borsh encoding, or by its raw bytes if the struct doesn't list borsh_fields:
+ *
+ * struct Fill {
+ *     static constexpr uint64_t DISCRIMINATOR = event_discriminator("Fill"); // sha256("event:Fill")[..8]
+ *     Pubkey maker;
+ *     uint64_t price;
+ *     uint64_t quantity;
+ *     using borsh_fields = BorshFields<&Fill::maker, &Fill::price, &Fill::quantity>;
+ * };
+ *
+ * emit_event(Fill{maker.pubkey(), price, quantity});
+ *
+ * Events of a fixed size are encoded into a buffer of that size on the stack. Variable-size events need the capacity of
+ * the buffer, e.g. emit_event<256>(event), and are not logged if they don't fit.
+ *
+ * decode_event() reverses emit_event() for off-chain consumers; host::program_data() (see host/sol_host.h) extracts the
+ * fields of a logged message.
+ *
+ * sol_log_data is not available before Solana 1.9; calling it on older clusters fails the transaction.
+ */
+
+#include <sol_borsh.h>
+#include <sol_bytes.h>
+#include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_logging.h>
+#include <sol_syscalls.h>
+
+namespace sol {
+
+namespace internal {
+
+template<class T, class ENABLE = void>
+struct has_borsh_fields {
+    static constexpr bool value = false;
+};
+
+template<class T>
+struct has_borsh_fields<T, void_t<typename T::borsh_fields>> {
+    static constexpr bool value = true;
+};
+
+// bytes of the event's encoding without the discriminator, or 0 if it has no fixed size
+template<class T>
+constexpr uint64_t event_size() {
+    if constexpr (!has_borsh_fields<T>::value) {
+        return sizeof(T);
+    } else if constexpr (BorshTraits<T>::FIXED) {
+        return BorshTraits<T>::SIZE;
+    } else {
+        return 0;
+    }
+}
+
+} // namespace internal
+
+// logs the parts as separate fields of one "Program data:" message
+template<typename... Ts>
+void log_data(const Ts&... parts) {
+    static_assert(sizeof...(Ts) > 0, "at least one field must be logged");
+    const Bytes fields[sizeof...(Ts)] = {internal::to_bytes(parts)...};
+    syscall::sol_log_data(fields, sizeof...(Ts));
+}
+
+// logs T::DISCRIMINATOR followed by the event's encoding as one field; CAPACITY bounds the encoding of variable-size events
+template<uint64_t CAPACITY = 0, class T>
+void emit_event(const T& event) {
+    constexpr uint64_t FIXED_SIZE = internal::event_size<T>();
+    static_assert(FIXED_SIZE != 0 || CAPACITY != 0, "variable-size events need a capacity, e.g. emit_event<256>(event)");
+    constexpr uint64_t SIZE = FIXED_SIZE != 0 ? FIXED_SIZE : CAPACITY;
+    uint8_t buffer[8 + SIZE];
+    const uint64_t discriminator = T::DISCRIMINATOR;
+    __builtin_memcpy(buffer, &discriminator, 8);
+    uint64_t len = SIZE;
+    if constexpr (!internal::has_borsh_fields<T>::value) {
+        __builtin_memcpy(buffer + 8, &event, sizeof(T));
+    } else {
+        len = borsh_encode(buffer + 8, SIZE, event);
+        if (len == 0 && FIXED_SIZE == 0) {
+            log_error("ERROR: Event exceeds the capacity of", CAPACITY, "bytes");
+            return;
+        }
+    }
+    log_data(Bytes{buffer, 8 + len});
+}
+
+// reads an event logged by emit_event, returning false if the discriminator or the encoding doesn't match a T
+template<class T>
+bool decode_event(const uint8_t* data, uint64_t len, T& event) {
+    uint64_t discriminator = 0;
+    if (len < 8) {
+        return false;
+    }
+    __builtin_memcpy(&discriminator, data, 8);
+    if (discriminator != T::DISCRIMINATOR) {
+        return false;
+    }
+    if constexpr (!internal::has_borsh_fields<T>::value) {
+        if (len - 8 != sizeof(T)) {
+            return false;
+        }
+        __builtin_memcpy(&event, data + 8, sizeof(T));
+        return true;
+    } else {
+        return borsh_decode(data + 8, len - 8, event) == SUCCESS;
+    }
+}
+
+} // namespace sol
@@ -0,0 +1,402 @@
+#pragma once
+/**
+ * SHA-256 and Keccak-256, at run time and at compile time
+ *
+ * sha256 and keccak256 hash the concatenation of any number of parts with a single syscall, without copying them into a buffer.
+ * Parts may be strings, Bytes, or objects such as Pubkeys, Hashes and integers, whose underlying bytes are hashed.
+ *
+ * Example:
+ * Hash leaf = sha256(uint8_t(0), owner.pubkey(), amount);
+ * Hash node = sha256(uint8_t(1), left, right);
+ * Hash digest = keccak256("prefix", Bytes{data, data_len});
+ *
+ * A Hasher collects up to MAX_SEGMENTS parts over time, e.g. in a loop, and then hashes them in a single syscall:
+ * Hasher<8> hasher;
+ * for (uint64_t i = 0; i != count; ++i) {
+ *     hasher.update(keys[i]);
+ * }
+ * Hash digest = hasher.sha256();
+ *
+ * The parts are referenced rather than copied, so they must outlive the call, or the Hasher respectively.
+ *
+ * The constexpr functions compute digests identical to those of the syscalls, but in the compiler, so constant hashes such as
+ * discriminators end up as literals in the program rather than costing a syscall per invocation.
+ *
+ * Example:
+ * constexpr Hash digest = const_sha256("hello world");
+ * constexpr uint64_t INITIALIZE = instruction_discriminator("initialize");  // Anchor's sighash of "global:initialize"
+ *
+ * struct Vault {
+ *     static constexpr uint64_t DISCRIMINATOR = account_discriminator("Vault");  // see sol_account_data.h
+ *     ...
+ * };
+ *
+ * ConstSha256 and ConstKeccak256 hash several pieces incrementally. They work at run time too, but the syscalls are far cheaper there.
+ * libsol_host implements the syscalls with them as well (see host/sol_host.h), and known-answer tests below check them.
+ */
+
+#include <sol_bytes.h>
+#include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_log_line.h>
+#include <sol_logging.h>
+#include <sol_string.h>
+#include <sol_syscall_wrappers.h>
+#include <sol_syscalls.h>
+
+namespace sol {
+
+// A 32-byte digest
+struct Hash {
+    uint8_t bytes[32];
+
+    // returns the first 8 bytes as a little-endian integer, like the discriminators of Anchor
+    constexpr uint64_t discriminator() const {
+        uint64_t word = 0;
+        for (int i = 7; i >= 0; --i) {
+            word = (word << 8) | bytes[i];
+        }
+        return word;
+    }
+};
+
+constexpr bool operator==(const Hash& left, const Hash& right) {
+    for (int i = 0; i != 32; ++i) {
+        if (left.bytes[i] != right.bytes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool operator!=(const Hash& left, const Hash& right) {
+    return !(left == right);
+}
+
+// formats the digest in Base58, like Pubkeys (see sol_log_line.h)
+inline LogWriter& operator<<(LogWriter& writer, const Hash& hash) {
+    char encoded[MAX_BASE58_PUBKEY_LEN];
+    return writer.append(encoded, to_base58(reinterpret_cast<const Pubkey&>(hash), encoded));
+}
+
+namespace internal {
+
+constexpr uint32_t SHA256_ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+constexpr uint64_t KECCAK_ROUND_CONSTANTS[24] = {
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808a, 0x8000000080008000,
+    0x000000000000808b, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
+    0x000000000000008a, 0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+    0x000000008000808b, 0x800000000000008b, 0x8000000000008089, 0x8000000000008003,
+    0x8000000000008002, 0x8000000000000080, 0x000000000000800a, 0x800000008000000a,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+};
+
+// rotation of each lane by the rho step, indexed by x + 5 * y
+constexpr int KECCAK_ROTATIONS[25] = {
+    0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14,
+};
+
+} // namespace internal
+
+class ConstSha256 {
+    uint32_t _state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    uint8_t _block[64] = {};
+    uint64_t _total = 0;  /** Bytes hashed so far */
+
+    static constexpr uint32_t rotr(uint32_t x, int n) {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    constexpr void compress() {
+        uint32_t w[64] = {};
+        for (int i = 0; i != 16; ++i) {
+            w[i] = uint32_t(_block[4 * i]) << 24 | uint32_t(_block[4 * i + 1]) << 16 |
+                   uint32_t(_block[4 * i + 2]) << 8 | _block[4 * i + 3];
+        }
+        for (int i = 16; i != 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+        uint32_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+        for (int i = 0; i != 64; ++i) {
+            const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) +
+                                internal::SHA256_ROUND_CONSTANTS[i] + w[i];
+            const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        _state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+        _state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+    }
+
+    constexpr void update_byte(uint8_t byte) {
+        _block[_total++ % 64] = byte;
+        if (_total % 64 == 0) {
+            compress();
+        }
+    }
+
+public:
+    constexpr ConstSha256& update(const uint8_t* data, uint64_t len) {
+        for (uint64_t i = 0; i != len; ++i) {
+            update_byte(data[i]);
+        }
+        return *this;
+    }
+
+    // hashes the string without its terminating zero
+    constexpr ConstSha256& update(const char* string) {
+        for (uint64_t i = 0; string[i] != '\0'; ++i) {
+            update_byte(uint8_t(string[i]));
+        }
+        return *this;
+    }
+
+    // returns the digest; the hasher must not be updated afterwards
+    constexpr Hash finish() {
+        const uint64_t bits = _total * 8;
+        update_byte(0x80);
+        while (_total % 64 != 56) {
+            update_byte(0);
+        }
+        for (int i = 7; i >= 0; --i) {
+            update_byte(uint8_t(bits >> (8 * i)));
+        }
+        Hash result = {};
+        for (int i = 0; i != 8; ++i) {
+            result.bytes[4 * i] = uint8_t(_state[i] >> 24);
+            result.bytes[4 * i + 1] = uint8_t(_state[i] >> 16);
+            result.bytes[4 * i + 2] = uint8_t(_state[i] >> 8);
+            result.bytes[4 * i + 3] = uint8_t(_state[i]);
+        }
+        return result;
+    }
+};
+
+// Keccak-256 with the original padding (as opposed to SHA3-256), like sol_keccak256
+class ConstKeccak256 {
+    static constexpr uint64_t RATE = 136;  /** Bytes absorbed per permutation */
+
+    uint64_t _state[25] = {};
+    uint64_t _position = 0;  /** Byte offset into the rate */
+
+    static constexpr uint64_t rotl(uint64_t x, int n) {
+        return n == 0 ? x : (x << n) | (x >> (64 - n));
+    }
+
+    constexpr void permute() {
+        for (int round = 0; round != 24; ++round) {
+            uint64_t c[5] = {};
+            for (int x = 0; x != 5; ++x) {
+                c[x] = _state[x] ^ _state[x + 5] ^ _state[x + 10] ^ _state[x + 15] ^ _state[x + 20];
+            }
+            for (int x = 0; x != 5; ++x) {
+                const uint64_t d = c[(x + 4) % 5] ^ rotl(c[(x + 1) % 5], 1);
+                for (int y = 0; y != 25; y += 5) {
+                    _state[y + x] ^= d;
+                }
+            }
+            uint64_t b[25] = {};
+            for (int x = 0; x != 5; ++x) {
+                for (int y = 0; y != 5; ++y) {
+                    b[y + 5 * ((2 * x + 3 * y) % 5)] = rotl(_state[x + 5 * y], internal::KECCAK_ROTATIONS[x + 5 * y]);
+                }
+            }
+            for (int x = 0; x != 5; ++x) {
+                for (int y = 0; y != 25; y += 5) {
+                    _state[y + x] = b[y + x] ^ (~b[y + (x + 1) % 5] & b[y + (x + 2) % 5]);
+                }
+            }
+            _state[0] ^= internal::KECCAK_ROUND_CONSTANTS[round];
+        }
+    }
+
+    constexpr void update_byte(uint8_t byte) {
+        _state[_position / 8] ^= uint64_t(byte) << (8 * (_position % 8));
+        if (++_position == RATE) {
+            permute();
+            _position = 0;
+        }
+    }
+
+public:
+    constexpr ConstKeccak256& update(const uint8_t* data, uint64_t len) {
+        for (uint64_t i = 0; i != len; ++i) {
+            update_byte(data[i]);
+        }
+        return *this;
+    }
+
+    // hashes the string without its terminating zero
+    constexpr ConstKeccak256& update(const char* string) {
+        for (uint64_t i = 0; string[i] != '\0'; ++i) {
+            update_byte(uint8_t(string[i]));
+        }
+        return *this;
+    }
+
+    // returns the digest; the hasher must not be updated afterwards
+    constexpr Hash finish() {
+        _state[_position / 8] ^= uint64_t(0x01) << (8 * (_position % 8));
+        _state[(RATE - 1) / 8] ^= uint64_t(0x80) << (8 * ((RATE - 1) % 8));
+        permute();
+        Hash result = {};
+        for (int i = 0; i != 32; ++i) {
+            result.bytes[i] = uint8_t(_state[i / 8] >> (8 * (i % 8)));
+        }
+        return result;
+    }
+};
+
+constexpr Hash const_sha256(const uint8_t* data, uint64_t len) {
+    return ConstSha256().update(data, len).finish();
+}
+
+constexpr Hash const_sha256(const char* string) {
+    return ConstSha256().update(string).finish();
+}
+
+constexpr Hash const_keccak256(const uint8_t* data, uint64_t len) {
+    return ConstKeccak256().update(data, len).finish();
+}
+
+constexpr Hash const_keccak256(const char* string) {
+    return ConstKeccak256().update(string).finish();
+}
+
+// returns Anchor's discriminator of an instruction, i.e. the first 8 bytes of sha256("global:<name>")
+constexpr uint64_t instruction_discriminator(const char* name) {
+    return ConstSha256().update("global:").update(name).finish().discriminator();
+}
+
+// returns Anchor's discriminator of an account type, i.e. the first 8 bytes of sha256("account:<name>")
+constexpr uint64_t account_discriminator(const char* name) {
+    return ConstSha256().update("account:").update(name).finish().discriminator();
+}
+
+// returns Anchor's discriminator of an event, i.e. the first 8 bytes of sha256("event:<name>")
+constexpr uint64_t event_discriminator(const char* name) {
+    return ConstSha256().update("event:").update(name).finish().discriminator();
+}
+
+namespace internal {
+
+// hashes count copies of a byte, for the known-answer tests below
+template<class HASHER>
+constexpr Hash hash_repeated(uint8_t byte, uint64_t count) {
+    HASHER hasher;
+    for (uint64_t i = 0; i != count; ++i) {
+        hasher.update(&byte, 1);
+    }
+    return hasher.finish();
+}
+
+constexpr bool equals_hex(const Hash& hash, const char (&hex)[65]) {
+    for (int i = 0; i != 64; ++i) {
+        const uint8_t nibble = uint8_t(hash.bytes[i / 2] >> (i % 2 == 0 ? 4 : 0)) & 15;
+        if (hex[i] != "0123456789abcdef"[nibble]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace internal
+
+// known answers around the padding boundaries: SHA-256 appends at least 9 bytes to 64-byte blocks, Keccak-256 at least
+// 1 byte to 136-byte blocks
+static_assert(internal::equals_hex(internal::hash_repeated<ConstSha256>('a', 0),
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+static_assert(internal::equals_hex(internal::hash_repeated<ConstSha256>('a', 55),
+    "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318"));
+static_assert(internal::equals_hex(internal::hash_repeated<ConstSha256>('a', 56),
+    "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a"));
+static_assert(internal::equals_hex(internal::hash_repeated<ConstSha256>('a', 64),
+    "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb"));
+static_assert(internal::equals_hex(internal::hash_repeated<ConstKeccak256>('a', 0),
+    "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"));
+static_assert(internal::equals_hex(internal::hash_repeated<ConstKeccak256>('a', 135),
+    "34367dc248bbd832f4e3e69dfaac2f92638bd0bbd18f2912ba4ef454919cf446"));
+static_assert(internal::equals_hex(internal::hash_repeated<ConstKeccak256>('a', 136),
+    "a6c4d403279fe3e0af03729caada8374b5ca54d8065329a3ebcaeb4b60aa386e"));
+static_assert(instruction_discriminator("initialize") == 0xed9b980d1f6dafaf, "Anchor's sighash of initialize");
+
+// hashes the concatenation of the parts with sol_sha256
+template<typename... Ts>
+Hash sha256(const Ts&... parts) {
+    static_assert(sizeof...(Ts) > 0, "at least one part must be hashed");
+    const Bytes segments[sizeof...(Ts)] = {internal::to_bytes(parts)...};
+    Hash result;
+    syscall::sol_sha256(segments, sizeof...(Ts), result.bytes);
+    return result;
+}
+
+// hashes the concatenation of the parts with sol_keccak256
+template<typename... Ts>
+Hash keccak256(const Ts&... parts) {
+    static_assert(sizeof...(Ts) > 0, "at least one part must be hashed");
+    const Bytes segments[sizeof...(Ts)] = {internal::to_bytes(parts)...};
+    Hash result;
+    syscall::sol_keccak256(segments, sizeof...(Ts), result.bytes);
+    return result;
+}
+
+// Collects up to MAX_SEGMENTS parts to be hashed in a single syscall
+template<uint64_t MAX_SEGMENTS>
+class Hasher {
+    Bytes _segments[MAX_SEGMENTS];
+    uint64_t _segments_len = 0;
+
+public:
+    Hasher() = default;
+    Hasher(const Hasher&) = delete;
+    Hasher& operator=(const Hasher&) = delete;
+
+    // appends the parts, which must outlive the Hasher
+    template<typename... Ts>
+    Hasher& update(const Ts&... parts) {
+        if (sizeof...(Ts) > MAX_SEGMENTS - _segments_len) {
+            log_error("ERROR: Hasher holds no more segments than", MAX_SEGMENTS);
+            sol_panic();
+        }
+        ((_segments[_segments_len++] = internal::to_bytes(parts)), ...);
+        return *this;
+    }
+
+    uint64_t segments_len() const {
+        return _segments_len;
+    }
+
+    // discards all parts
+    void reset() {
+        _segments_len = 0;
+    }
+
+    Hash sha256() const {
+        Hash result;
+        syscall::sol_sha256(_segments, _segments_len, result.bytes);
+        return result;
+    }
+
+    Hash keccak256() const {
+        Hash result;
+        syscall::sol_keccak256(_segments, _segments_len, result.bytes);
+        return result;
+    }
+};
+
+} // namespace sol
@@ -0,0 +1,406 @@
+#pragma once
+/**
+ * Lazy, zero-copy access to a program's input
+ *
+ * Unlike deserialize() (see sol_serialization.h), an InputView doesn't copy anything into AccountInfo objects up front.
+ * Accounts are only located when they are asked for, and an AccountView points directly into the input buffer.
+ * This saves compute units and stack space when an instruction receives many accounts but only reads a few of them.
+ *
+ * Example:
+ * extern "C" uint64_t entrypoint(const uint8_t* input) {
+ *     InputView view(input);
+ *     if (view.accounts_given() < 2) {
+ *         return error::NOT_ENOUGH_ACCOUNT_KEYS;
+ *     }
+ *     AccountCursor cursor = view.accounts();
+ *     AccountView payer = cursor.next();
+ *     cursor.skip(1);
+ *     AccountView vault = cursor.next();
+ *     log("program", view.program_id(), "payer", payer.pubkey(), "vault", vault.pubkey());
+ *     // ...
+ *     return SUCCESS;
+ * }
+ *
+ * Duplicate accounts are resolved to the AccountView of their first occurrence.
+ * For a cross-program invocation, an AccountView can be materialized into an AccountInfo by calling info().
+ *
+ * An AccountHandle is the compact form for keeping many accounts around: the 32-bit offset of the serialized account
+ * in the input, which is always mapped at INPUT_START, and a byte of flags. At 8 bytes it's a seventh of an AccountInfo.
+ * The accounts of a cross-program invocation are passed as handles, and only those are materialized as AccountInfos:
+ *
+ * AccountHandle accounts[64];
+ * const uint64_t count = view.handles(accounts);
+ * // ...
+ * invoke(transfer_instruction, {accounts[0], accounts[5], accounts[2]});
+ */
+
+#include <sol_account.h>
+#include <sol_int.h>
+#include <sol_limits.h>
+#include <sol_logging.h>
+#include <sol_memory.h>
+#include <sol_pubkey.h>
+#include <sol_syscall_wrappers.h>
+
+#ifdef SOL_HOST
+// host builds have no fixed input address, the input is provided by libsol_host (see host/sol_host.h)
+extern "C" sol::uint8_t* sol_host_input;
+#endif
+
+namespace sol {
+
+// returns the start of the program's input
+inline uint8_t* input_start() {
+#ifdef SOL_HOST
+    return sol_host_input;
+#else
+    return reinterpret_cast<uint8_t*>(INPUT_START);
+#endif
+}
+
+// Views a serialized account in the program's input. It's the caller's responsibility that the input outlives the view.
+class AccountView {
+    friend class AccountCursor;
+    friend class AccountHandle;
+    friend class InputView;
+
+    // layout of a serialized, non-duplicate account
+    static constexpr uint64_t IS_SIGNER_OFFSET = 1;
+    static constexpr uint64_t IS_WRITABLE_OFFSET = 2;
+    static constexpr uint64_t EXECUTABLE_OFFSET = 3;
+    static constexpr uint64_t PUBKEY_OFFSET = 8;
+    static constexpr uint64_t OWNER_OFFSET = PUBKEY_OFFSET + sizeof(Pubkey);
+    static constexpr uint64_t LAMPORTS_OFFSET = OWNER_OFFSET + sizeof(Pubkey);
+    static constexpr uint64_t DATA_LEN_OFFSET = LAMPORTS_OFFSET + sizeof(Lamports);
+    static constexpr uint64_t DATA_OFFSET = DATA_LEN_OFFSET + sizeof(uint64_t);
+    static constexpr uint64_t DUPLICATE_SIZE = 8;
+
+    uint8_t* _record;  /** Start of the serialized account, i.e. its dup_info byte */
+
+    explicit AccountView(uint8_t* record) : _record(record) {
+    }
+
+    // returns the offset of rent_epoch, which follows the data and the space reserved for reallocation
+    uint64_t rent_epoch_offset() const {
+        return aligned<8>(DATA_OFFSET + internal::original_data_len(data()) + MAX_PERMITTED_DATA_INCREASE);
+    }
+
+    // returns the size of the serialized account, given the start of it
+    static uint64_t record_size(const uint8_t* record) {
+        if (record[0] != UINT8_MAX) {
+            return DUPLICATE_SIZE;
+        }
+        return AccountView(const_cast<uint8_t*>(record)).rent_epoch_offset() + sizeof(Epoch);
+    }
+
+public:
+    const Pubkey& pubkey() const {
+        return *reinterpret_cast<const Pubkey*>(_record + PUBKEY_OFFSET);
+    }
+
+    const Lamports& lamports() const {
+        return *reinterpret_cast<const Lamports*>(_record + LAMPORTS_OFFSET);
+    }
+
+    Lamports& lamports() {
+        return *reinterpret_cast<Lamports*>(_record + LAMPORTS_OFFSET);
+    }
+
+    const uint64_t& data_len() const {
+        return *reinterpret_cast<const uint64_t*>(_record + DATA_LEN_OFFSET);
+    }
+
+    const uint8_t* data() const {
+        return _record + DATA_OFFSET;
+    }
+
+    uint8_t* data() {
+        return _record + DATA_OFFSET;
+    }
+
+    const Pubkey& owner() const {
+        return *reinterpret_cast<const Pubkey*>(_record + OWNER_OFFSET);
+    }
+
+    const Epoch& rent_epoch() const {
+        return *reinterpret_cast<const Epoch*>(_record + rent_epoch_offset());
+    }
+
+    bool is_signer() const {
+        return _record[IS_SIGNER_OFFSET] != 0;
+    }
+
+    bool is_writable() const {
+        return _record[IS_WRITABLE_OFFSET] != 0;
+    }
+
+    bool executable() const {
+        return _record[EXECUTABLE_OFFSET] != 0;
+    }
+
+    // materializes the AccountInfo expected by cross-program invocations
+    AccountInfo info() const {
+        AccountInfo info;
+        info._pubkey = reinterpret_cast<Pubkey*>(_record + PUBKEY_OFFSET);
+        info._lamports = reinterpret_cast<Lamports*>(_record + LAMPORTS_OFFSET);
+        info._data_len = data_len();
+        info._data = _record + DATA_OFFSET;
+        info._owner = reinterpret_cast<Pubkey*>(_record + OWNER_OFFSET);
+        info._rent_epoch = rent_epoch();
+        info._is_signer = is_signer();
+        info._is_writable = is_writable();
+        info._executable = executable();
+        return info;
+    }
+};
+
+// Refers to a serialized account by its offset in the program's input, with its flags at hand. A default-constructed
+// handle refers to no account; its offset of 0 is that of the account count, which precedes all accounts.
+class AccountHandle {
+    uint32_t _offset;  /** Offset of the serialized account from input_start(), or 0 */
+    uint8_t _flags;    /** SIGNER, WRITABLE and EXECUTABLE */
+
+    static constexpr uint8_t SIGNER = 1;
+    static constexpr uint8_t WRITABLE = 2;
+    static constexpr uint8_t EXECUTABLE = 4;
+
+public:
+    AccountHandle() : _offset(0), _flags(0) {
+    }
+
+    // the view must point into the program's input, whose serialized accounts start within its first 4 GB
+    explicit AccountHandle(const AccountView& view) :
+        _offset(uint32_t(view._record - input_start())),
+        _flags(uint8_t(view.is_signer() * SIGNER | view.is_writable() * WRITABLE | view.executable() * EXECUTABLE)) {
+    }
+
+    // whether the handle refers to an account, i.e. wasn't default-constructed
+    bool is_valid() const {
+        return _offset != 0;
+    }
+
+    // view() and the accessors reading the account panic for a handle that isn't valid, whose flags are all false
+    AccountView view() const {
+        if (!is_valid()) {
+            log_error("ERROR: AccountHandle doesn't refer to an account");
+            sol_panic();
+        }
+        return AccountView(input_start() + _offset);
+    }
+
+    const Pubkey& pubkey() const {
+        return view().pubkey();
+    }
+
+    Lamports& lamports() const {
+        return view().lamports();
+    }
+
+    const uint64_t& data_len() const {
+        return view().data_len();
+    }
+
+    uint8_t* data() const {
+        return view().data();
+    }
+
+    const Pubkey& owner() const {
+        return view().owner();
+    }
+
+    bool is_signer() const {
+        return (_flags & SIGNER) != 0;
+    }
+
+    bool is_writable() const {
+        return (_flags & WRITABLE) != 0;
+    }
+
+    bool executable() const {
+        return (_flags & EXECUTABLE) != 0;
+    }
+
+    // materializes the AccountInfo expected by cross-program invocations
+    AccountInfo info() const {
+        return view().info();
+    }
+};
+
+static_assert(sizeof(AccountHandle) == 8, "AccountHandle should be compact");
+
+// Iterates over the accounts in the program's input, front to back
+class AccountCursor {
+    friend class InputView;
+
+    uint8_t* _first;     /** First serialized account, for resolving duplicates */
+    uint8_t* _next;      /** Serialized account to be returned by next() */
+    uint64_t _index;     /** Index of _next */
+    uint64_t _count;     /** Number of accounts in the input */
+
+    AccountCursor(uint8_t* first, uint64_t count) :
+        _first(first),
+        _next(first),
+        _index(0),
+        _count(count) {
+    }
+
+    // returns the serialized account at the given index, walking from the first
+    uint8_t* find(uint64_t index) const {
+        uint8_t* record = _first;
+        for (uint64_t i = 0; i != index; ++i) {
+            record += AccountView::record_size(record);
+        }
+        return record;
+    }
+
+public:
+    // returns the number of accounts not yet visited
+    uint64_t remaining() const {
+        return _count - _index;
+    }
+
+    // returns the index of the account next() will return
+    uint64_t index() const {
+        return _index;
+    }
+
+    // returns the next account, resolving a duplicate to its first occurrence
+    AccountView next() {
+        if (_index == _count) {
+            log_error("ERROR: No more accounts in the input");
+            sol_panic();
+        }
+        uint8_t* record = _next;
+        _next += AccountView::record_size(record);
+        ++_index;
+        if (record[0] != UINT8_MAX) {
+            record = find(record[0]);
+        }
+        return AccountView(record);
+    }
+
+    // jumps over the given number of accounts without looking at them
+    void skip(uint64_t accounts) {
+        if (accounts > remaining()) {
+            log_error("ERROR: Cannot skip past the last account");
+            sol_panic();
+        }
+        for (uint64_t i = 0; i != accounts; ++i) {
+            _next += AccountView::record_size(_next);
+        }
+        _index += accounts;
+    }
+};
+
+// Parses the header of the program's input; accounts are only located on demand.
+class InputView {
+    uint8_t* _accounts;                 /** First serialized account */
+    uint64_t _accounts_given;           /** Number of accounts in the input */
+    const uint8_t* _instruction_data;   /** Instruction data, following the accounts */
+    uint64_t _instruction_data_len;     /** Length of the instruction data in bytes */
+    const Pubkey* _program_id;          /** Id of the running program, following the instruction data */
+
+public:
+    explicit InputView(const uint8_t* input) {
+        if (input == nullptr) {
+            log_error("ERROR: No input given");
+            sol_panic();
+        }
+        uint8_t* position = const_cast<uint8_t*>(input);
+        _accounts_given = *reinterpret_cast<const uint64_t*>(position);
+        position += sizeof(uint64_t);
+        _accounts = position;
+
+        // jump over the accounts, reading nothing but their data lengths
+        for (uint64_t i = 0; i != _accounts_given; ++i) {
+            position += AccountView::record_size(position);
+        }
+
+        _instruction_data_len = *reinterpret_cast<const uint64_t*>(position);
+        position += sizeof(uint64_t);
+        _instruction_data = position;
+        position += _instruction_data_len;
+
+        _program_id = reinterpret_cast<const Pubkey*>(position);
+    }
+
+    uint64_t accounts_given() const {
+        return _accounts_given;
+    }
+
+    // returns a cursor positioned at the first account
+    AccountCursor accounts() const {
+        return AccountCursor(_accounts, _accounts_given);
+    }
+
+    // fills the array with handles of the first accounts, duplicates resolved, and returns how many it filled: the number
+    // of accounts given, but at most MAX_ACCOUNTS. Compare it with accounts_given() to reject instructions with more.
+    template<uint64_t MAX_ACCOUNTS>
+    uint64_t handles(AccountHandle (&accounts)[MAX_ACCOUNTS]) const {
+        AccountCursor cursor = this->accounts();
+        const uint64_t count = _accounts_given < MAX_ACCOUNTS ? _accounts_given : MAX_ACCOUNTS;
+        for (uint64_t i = 0; i != count; ++i) {
+            accounts[i] = AccountHandle(cursor.next());
+        }
+        return count;
+    }
+
+    // returns the account at the given index; iterate with accounts() to visit several accounts in order
+    AccountView account(uint64_t index) const {
+        AccountCursor cursor = accounts();
+        cursor.skip(index);
+        return cursor.next();
+    }
+
+    const uint8_t* instruction_data() const {
+        return _instruction_data;
+    }
+
+    uint64_t instruction_data_len() const {
+        return _instruction_data_len;
+    }
+
+    const Pubkey& program_id() const {
+        return *_program_id;
+    }
+};
+
+inline void log(const AccountView& account) {
+    log(account.info());
+}
+
+namespace internal {
+
+template<uint64_t ACCOUNTS>
+uint64_t invoke_handles(
+    const Instruction& instruction,
+    const AccountHandle (&accounts)[ACCOUNTS],
+    const SignerSeeds* signer_seeds,
+    uint64_t signers
+) {
+    AccountInfo account_infos[ACCOUNTS];
+    for (uint64_t i = 0; i != ACCOUNTS; ++i) {
+        account_infos[i] = accounts[i].info();
+    }
+    // the runtime updates the data_len in the input too, where the handles read it
+    return invoke_signed_c(instruction, account_infos, ACCOUNTS, signer_seeds, signers);
+}
+
+} // namespace internal
+
+// invoke with AccountInfos materialized from the handles, which must include the invoked program
+template<uint64_t ACCOUNTS>
+uint64_t invoke(const Instruction& instruction, const AccountHandle (&accounts)[ACCOUNTS]) {
+    return internal::invoke_handles(instruction, accounts, nullptr, 0);
+}
+
+template<uint64_t ACCOUNTS, uint64_t SIGNERS>
+uint64_t invoke_signed(
+    const Instruction& instruction,
+    const AccountHandle (&accounts)[ACCOUNTS],
+    const SignerSeeds (&signer_seeds_array)[SIGNERS]
+) {
+    return internal::invoke_handles(instruction, accounts, signer_seeds_array, SIGNERS);
+}
+
+} // namespace sol
@@ -6,13 +6,46 @@
  *
  * Importantly, an Instruction does NOT copy, but only references the bytes.
  * It is the user's responsibility to ensure the validity of the referenced memory for as long as the Instruction is used.
+ *
+ * Alternatively, an InstructionBuilder stores the AccountMetas and data inline, up to a fixed capacity.
+ * It converts to an Instruction implicitly, so it can be passed to invoke_signed directly.
+ *
+ * Example:
+ * InstructionBuilder<2, sizeof(native::SystemProgram::TransferParams)> transfer(native::SystemProgram::pubkey());
+ * transfer.writable_signer(payer.pubkey())
+ *         .writable(recipient.pubkey())
+ *         .data(native::SystemProgram::TransferParams(lamports));
+ * invoke(transfer, account_infos);
+ *
+ * AccountMetas still reference the Pubkeys, which must outlive the builder.
+ *
+ * invoke and invoke_signed pass the entire AccountInfo array to the invoked program, which the runtime has to search
+ * for every account of the instruction. The variants below pass only the accounts actually referenced instead:
+ * invoke_subset and invoke_signed_subset take their indices as template arguments, while invoke_referenced and
+ * invoke_signed_referenced find them by pubkey.
+ *
+ * Example:
+ * invoke_signed_subset<1, 2>(allocate_instruction, account_infos, {{{"1234", SignerSeed(pda.bump_seed)}}});
+ * invoke_referenced(memo_instruction, account_infos, accounts_given);
+ *
+ * The runtime expects the invoked program's own AccountInfo too, so its index belongs in the list of a subset. Those
+ * found by pubkey include it when given.
+ *
+ * Each of these also takes a pointer to a table of AccountInfos and its length in place of the array, such as the
+ * AccountInfos an InstructionContext holds (see sol_entrypoint.h):
+ * invoke_referenced(memo_instruction, context.account_infos, context.accounts_given);
  */
 
+#include <sol_account.h>
+#include <sol_borsh.h>
 #include <sol_int.h>
+#include <sol_logging.h>
+#include <sol_memory.h>
+#include <sol_status_codes.h>
+#include <sol_syscall_wrappers.h>
 
 namespace sol {
 
-class AccountMeta;
 class Pubkey;
 
 class Instruction {
@@ -40,6 +73,319 @@ public:
         _data(reinterpret_cast<const uint8_t*>(data)),
         _data_len(bytes) {
     }
+
+    Instruction(const Pubkey& program_id, const AccountMeta* accounts, uint64_t accounts_len, const void* data, uint64_t bytes) :
+        _program_id(&program_id),
+        _accounts(accounts),
+        _accounts_len(accounts_len),
+        _data(reinterpret_cast<const uint8_t*>(data)),
+        _data_len(bytes) {
+    }
+
+    const Pubkey& program_id() const {
+        return *_program_id;
+    }
+
+    const AccountMeta* accounts() const {
+        return _accounts;
+    }
+
+    uint64_t accounts_len() const {
+        return _accounts_len;
+    }
+};
+
+// Builds an Instruction with up to MAX_ACCOUNTS accounts and MAX_DATA bytes of data, in place.
+template<uint64_t MAX_ACCOUNTS, uint64_t MAX_DATA>
+class InstructionBuilder {
+    const Pubkey* _program_id;
+    AccountMeta _accounts[MAX_ACCOUNTS];
+    uint64_t _accounts_len;
+    uint8_t _data[MAX_DATA];
+    uint64_t _data_len;
+
+public:
+    explicit InstructionBuilder(const Pubkey& program_id) :
+        _program_id(&program_id),
+        _accounts_len(0),
+        _data_len(0) {
+    }
+
+    InstructionBuilder(const InstructionBuilder&) = delete;
+    InstructionBuilder& operator=(const InstructionBuilder&) = delete;
+
+    // appends an account
+    InstructionBuilder& account(const Pubkey& pubkey, bool is_writable, bool is_signer) {
+        if (_accounts_len == MAX_ACCOUNTS) {
+            log_error("ERROR: InstructionBuilder holds no more accounts than", MAX_ACCOUNTS);
+            sol_panic();
+        }
+        _accounts[_accounts_len++] = {&pubkey, is_writable, is_signer};
+        return *this;
+    }
+
+    InstructionBuilder& readonly(const Pubkey& pubkey) {
+        return account(pubkey, false, false);
+    }
+
+    InstructionBuilder& writable(const Pubkey& pubkey) {
+        return account(pubkey, true, false);
+    }
+
+    InstructionBuilder& signer(const Pubkey& pubkey) {
+        return account(pubkey, false, true);
+    }
+
+    InstructionBuilder& writable_signer(const Pubkey& pubkey) {
+        return account(pubkey, true, true);
+    }
+
+    // appends bytes to the data
+    InstructionBuilder& bytes(const void* data, uint64_t len) {
+        if (len > MAX_DATA - _data_len) {
+            log_error("ERROR: InstructionBuilder holds no more bytes than", MAX_DATA);
+            sol_panic();
+        }
+        memcpy(_data + _data_len, data, len);
+        _data_len += len;
+        return *this;
+    }
+
+    // appends the underlying byte representation of an object to the data (see sol_native.h)
+    template<class T>
+    InstructionBuilder& data(const T& value) {
+        static_assert(sizeof(T) <= MAX_DATA, "the data does not fit into the InstructionBuilder");
+        return bytes(&value, sizeof(value));
+    }
+
+    // appends the Borsh encoding of an object to the data (see sol_borsh.h)
+    template<class T>
+    InstructionBuilder& borsh(const T& value) {
+        BorshWriter writer(_data + _data_len, MAX_DATA - _data_len);
+        if (!writer.write(value)) {
+            log_error("ERROR: InstructionBuilder holds no more bytes than", MAX_DATA);
+            sol_panic();
+        }
+        _data_len += writer.size();
+        return *this;
+    }
+
+    uint64_t accounts_len() const {
+        return _accounts_len;
+    }
+
+    const AccountMeta* accounts() const {
+        return _accounts;
+    }
+
+    uint64_t data_len() const {
+        return _data_len;
+    }
+
+    // references the builder's storage, which must outlive the Instruction
+    operator Instruction() const {
+        return Instruction(*_program_id, _accounts, _accounts_len, _data, _data_len);
+    }
 };
 
+namespace internal {
+
+// transactions index their accounts with a u8
+constexpr uint64_t MAX_REFERENCED_ACCOUNTS = 256;
+
+// selects the pointer overloads for AccountInfo* only, leaving arrays to the overloads that know their size
+template<class P>
+using if_account_info_pointer = typename enable_if<is_same<P, AccountInfo*>::value, uint64_t>::type;
+
+template<uint64_t... Is>
+uint64_t invoke_subset(
+    const Instruction& instruction,
+    AccountInfo* account_infos,
+    const SignerSeeds* signer_seeds,
+    uint64_t signers
+) {
+    static_assert(sizeof...(Is) > 0, "at least the invoked program must be passed");
+    AccountInfo subset[sizeof...(Is)] = {account_infos[Is]...};
+    const uint64_t result = internal::invoke_signed_c(instruction, subset, sizeof...(Is), signer_seeds, signers);
+    // the runtime updates the data_len of the AccountInfos it was passed, i.e. of the copies
+    uint64_t i = 0;
+    ((account_infos[Is] = subset[i++]), ...);
+    return result;
+}
+
+template<uint64_t... Is>
+uint64_t invoke_subset(
+    const Instruction& instruction,
+    AccountInfo* account_infos,
+    uint64_t account_infos_len,
+    const SignerSeeds* signer_seeds,
+    uint64_t signers
+) {
+    if (!((Is < account_infos_len) && ...)) {
+        log_error("ERROR: invoke_subset was given fewer AccountInfos than it indexes:", account_infos_len);
+        return error::NOT_ENOUGH_ACCOUNT_KEYS;
+    }
+    return invoke_subset<Is...>(instruction, account_infos, signer_seeds, signers);
+}
+
+inline void swap(AccountInfo& left, AccountInfo& right) {
+    const AccountInfo temp = left;
+    left = right;
+    right = temp;
+}
+
+// moves the AccountInfo of the key right after the selected ones, unless it's one of those; returns whether it was found
+inline bool select_account(
+    const Pubkey& key,
+    AccountInfo* account_infos,
+    uint64_t accounts_given,
+    uint8_t* moved_from,
+    uint64_t& selected
+) {
+    for (uint64_t i = 0; i != accounts_given; ++i) {
+        // AccountMetas usually point to the pubkey of an AccountInfo, so most matches don't need a comparison
+        if (&account_infos[i].pubkey() == &key || account_infos[i].pubkey() == key) {
+            if (i >= selected) {
+                swap(account_infos[selected], account_infos[i]);
+                moved_from[selected++] = i;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// undoes the moves of select_account in reverse order
+inline void restore_accounts(AccountInfo* account_infos, const uint8_t* moved_from, uint64_t selected) {
+    while (selected != 0) {
+        --selected;
+        swap(account_infos[selected], account_infos[moved_from[selected]]);
+    }
+}
+
+// moved_from holds an index for each of the accounts_given AccountInfos, of which there are at most 256
+inline uint64_t invoke_referenced(
+    const Instruction& instruction,
+    AccountInfo* account_infos,
+    uint64_t accounts_given,
+    uint8_t* moved_from,
+    const SignerSeeds* signer_seeds,
+    uint64_t signers
+) {
+    // the referenced AccountInfos are swapped to the front of the array rather than copied, which keeps the stack small
+    uint64_t selected = 0;
+    const AccountMeta* metas = instruction.accounts();
+    for (uint64_t i = 0; i != instruction.accounts_len(); ++i) {
+        if (!select_account(*metas[i].pubkey, account_infos, accounts_given, moved_from, selected)) {
+            restore_accounts(account_infos, moved_from, selected);
+            log_error("ERROR: The instruction references an account that wasn't given:", *metas[i].pubkey);
+            return error::NOT_ENOUGH_ACCOUNT_KEYS;
+        }
+    }
+    // newer runtimes don't require the program's AccountInfo, so it's passed only if given
+    select_account(instruction.program_id(), account_infos, accounts_given, moved_from, selected);
+
+    const uint64_t result = internal::invoke_signed_c(instruction, account_infos, selected, signer_seeds, signers);
+    restore_accounts(account_infos, moved_from, selected);
+    return result;
+}
+
+// the number of AccountInfos invoke_referenced searches, of a table holding capacity
+constexpr uint64_t searched_accounts(uint64_t accounts_given, uint64_t capacity) {
+    return accounts_given < capacity ? accounts_given : capacity;
+}
+
+} // namespace internal
+
+// invoke with only account_infos[Is]...
+template<uint64_t... Is, uint64_t ACCOUNTS>
+uint64_t invoke_subset(const Instruction& instruction, AccountInfo (&account_infos)[ACCOUNTS]) {
+    static_assert(((Is < ACCOUNTS) && ...), "account index out of range");
+    return internal::invoke_subset<Is...>(instruction, account_infos, nullptr, 0);
+}
+
+// invoke_signed with only account_infos[Is]...
+template<uint64_t... Is, uint64_t ACCOUNTS, uint64_t SIGNERS>
+uint64_t invoke_signed_subset(
+    const Instruction& instruction,
+    AccountInfo (&account_infos)[ACCOUNTS],
+    const SignerSeeds (&signer_seeds_array)[SIGNERS]
+) {
+    static_assert(((Is < ACCOUNTS) && ...), "account index out of range");
+    return internal::invoke_subset<Is...>(instruction, account_infos, signer_seeds_array, SIGNERS);
+}
+
+// invoke with only account_infos[Is]... of a table of account_infos_len, or error::NOT_ENOUGH_ACCOUNT_KEYS
+template<uint64_t... Is>
+uint64_t invoke_subset(const Instruction& instruction, AccountInfo* account_infos, uint64_t account_infos_len) {
+    return internal::invoke_subset<Is...>(instruction, account_infos, account_infos_len, nullptr, 0);
+}
+
+// invoke_signed with only account_infos[Is]... of a table of account_infos_len, or error::NOT_ENOUGH_ACCOUNT_KEYS
+template<uint64_t... Is, uint64_t SIGNERS>
+uint64_t invoke_signed_subset(
+    const Instruction& instruction,
+    AccountInfo* account_infos,
+    uint64_t account_infos_len,
+    const SignerSeeds (&signer_seeds_array)[SIGNERS]
+) {
+    return internal::invoke_subset<Is...>(instruction, account_infos, account_infos_len, signer_seeds_array, SIGNERS);
+}
+
+// invoke with only those of the first accounts_given AccountInfos that the instruction references
+template<uint64_t ACCOUNTS>
+uint64_t invoke_referenced(
+    const Instruction& instruction,
+    AccountInfo (&account_infos)[ACCOUNTS],
+    uint64_t accounts_given
+) {
+    static_assert(ACCOUNTS <= internal::MAX_REFERENCED_ACCOUNTS, "transactions reference at most 256 accounts");
+    uint8_t moved_from[ACCOUNTS];
+    accounts_given = internal::searched_accounts(accounts_given, ACCOUNTS);
+    return internal::invoke_referenced(instruction, account_infos, accounts_given, moved_from, nullptr, 0);
+}
+
+// invoke_signed with only those of the first accounts_given AccountInfos that the instruction references
+template<uint64_t ACCOUNTS, uint64_t SIGNERS>
+uint64_t invoke_signed_referenced(
+    const Instruction& instruction,
+    AccountInfo (&account_infos)[ACCOUNTS],
+    uint64_t accounts_given,
+    const SignerSeeds (&signer_seeds_array)[SIGNERS]
+) {
+    static_assert(ACCOUNTS <= internal::MAX_REFERENCED_ACCOUNTS, "transactions reference at most 256 accounts");
+    uint8_t moved_from[ACCOUNTS];
+    accounts_given = internal::searched_accounts(accounts_given, ACCOUNTS);
+    return internal::invoke_referenced(
+        instruction, account_infos, accounts_given, moved_from, signer_seeds_array, SIGNERS
+    );
+}
+
+// invoke_referenced for a table of accounts_given AccountInfos, e.g. the one deserialized onto the heap
+template<class P>
+internal::if_account_info_pointer<P> invoke_referenced(
+    const Instruction& instruction,
+    P account_infos,
+    uint64_t accounts_given
+) {
+    uint8_t moved_from[internal::MAX_REFERENCED_ACCOUNTS];
+    accounts_given = internal::searched_accounts(accounts_given, internal::MAX_REFERENCED_ACCOUNTS);
+    return internal::invoke_referenced(instruction, account_infos, accounts_given, moved_from, nullptr, 0);
+}
+
+// invoke_signed_referenced for a table of accounts_given AccountInfos, e.g. the one deserialized onto the heap
+template<class P, uint64_t SIGNERS>
+internal::if_account_info_pointer<P> invoke_signed_referenced(
+    const Instruction& instruction,
+    P account_infos,
+    uint64_t accounts_given,
+    const SignerSeeds (&signer_seeds_array)[SIGNERS]
+) {
+    uint8_t moved_from[internal::MAX_REFERENCED_ACCOUNTS];
+    accounts_given = internal::searched_accounts(accounts_given, internal::MAX_REFERENCED_ACCOUNTS);
+    return internal::invoke_referenced(
+        instruction, account_infos, accounts_given, moved_from, signer_seeds_array, SIGNERS
+    );
+}
+
 } // namespace sol
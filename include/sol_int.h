@@ -36,30 +36,30 @@ class Epoch {
     uint64_t epoch;
 
 public:
-    Epoch() : epoch(0) {}
-    explicit Epoch(uint64_t epoch) : epoch(epoch) {}
+    constexpr Epoch() : epoch(0) {}
+    explicit constexpr Epoch(uint64_t epoch) : epoch(epoch) {}
 
-    operator uint64_t() const {return epoch;}
+    constexpr operator uint64_t() const {return epoch;}
 };
 
 class Lamports {
     uint64_t lamports;
 
 public:
-    Lamports() : lamports(0) {}
-    explicit Lamports(uint64_t lamports) : lamports(lamports) {}
+    constexpr Lamports() : lamports(0) {}
+    explicit constexpr Lamports(uint64_t lamports) : lamports(lamports) {}
 
-    operator uint64_t() const {return lamports;}
+    constexpr operator uint64_t() const {return lamports;}
 };
 
 class Slot {
     uint64_t slot;
 
 public:
-    Slot() : slot(0) {}
-    explicit Slot(uint64_t slot) : slot(slot) {}
+    constexpr Slot() : slot(0) {}
+    explicit constexpr Slot(uint64_t slot) : slot(slot) {}
 
-    operator uint64_t() const {return slot;}
+    constexpr operator uint64_t() const {return slot;}
 };
 
 } // namespace sol
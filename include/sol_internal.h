@@ -6,10 +6,87 @@
  * Ideally, the standard headers should be added to Solana's clang++ distribution instead.
  */
 
+#include <sol_int.h>
+
 namespace sol::internal {
 
 // std::enable_if from <type_traits>
 template<bool B, class T = void> struct enable_if {};
 template<class T> struct enable_if<true, T> { typedef T type; };
 
+// std::conditional from <type_traits>
+template<bool B, class T, class F> struct conditional { typedef T type; };
+template<class T, class F> struct conditional<false, T, F> { typedef F type; };
+
+// std::void_t from <type_traits>
+template<class...> using void_t = void;
+
+// std::index_sequence and std::make_index_sequence from <utility>
+template<uint64_t... Is> struct index_sequence {};
+
+template<uint64_t N, uint64_t... Is>
+struct make_index_sequence_impl : make_index_sequence_impl<N - 1, N - 1, Is...> {};
+template<uint64_t... Is>
+struct make_index_sequence_impl<0, Is...> { typedef index_sequence<Is...> type; };
+
+template<uint64_t N>
+using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+// the type at index I of a parameter pack, like std::tuple_element
+template<uint64_t I, class T, class... Ts> struct type_at { typedef typename type_at<I - 1, Ts...>::type type; };
+template<class T, class... Ts> struct type_at<0, T, Ts...> { typedef T type; };
+
+// std::remove_reference from <type_traits>
+template<class T> struct remove_reference { typedef T type; };
+template<class T> struct remove_reference<T&> { typedef T type; };
+template<class T> struct remove_reference<T&&> { typedef T type; };
+
+// std::remove_cvref from <type_traits>, ignoring volatile
+template<class T> struct remove_cvref { typedef typename remove_reference<T>::type type; };
+template<class T> struct remove_cvref<const T&> { typedef T type; };
+template<class T> struct remove_cvref<const T> { typedef T type; };
+
+// std::is_same from <type_traits>
+template<class T, class U> struct is_same { static constexpr bool value = false; };
+template<class T> struct is_same<T, T> { static constexpr bool value = true; };
+
+// std::is_pointer from <type_traits>, ignoring cv-qualified pointers
+template<class T> struct is_pointer { static constexpr bool value = false; };
+template<class T> struct is_pointer<T*> { static constexpr bool value = true; };
+
+// std::is_integral from <type_traits>, limited to the fixed-width integers and without bool and char
+template<class T> struct is_integer { static constexpr bool value = false; };
+template<> struct is_integer<int8_t> { static constexpr bool value = true; };
+template<> struct is_integer<uint8_t> { static constexpr bool value = true; };
+template<> struct is_integer<int16_t> { static constexpr bool value = true; };
+template<> struct is_integer<uint16_t> { static constexpr bool value = true; };
+template<> struct is_integer<int32_t> { static constexpr bool value = true; };
+template<> struct is_integer<uint32_t> { static constexpr bool value = true; };
+template<> struct is_integer<int64_t> { static constexpr bool value = true; };
+template<> struct is_integer<uint64_t> { static constexpr bool value = true; };
+
+// std::forward from <utility>
+template<class T>
+constexpr T&& forward(typename remove_reference<T>::type& t) noexcept {
+    return static_cast<T&&>(t);
+}
+
+template<class T>
+constexpr T&& forward(typename remove_reference<T>::type&& t) noexcept {
+    return static_cast<T&&>(t);
+}
+
+// tag for the SDK's placement new, since <new> isn't available (see sol_arena.h)
+struct placement_tag {};
+
+// returns first if it's non-zero, otherwise second, without branching
+constexpr uint64_t first_nonzero(uint64_t first, uint64_t second) {
+    return first | (second & (static_cast<uint64_t>(first != 0) - 1));
+}
+
 } // namespace sol::internal
+
+// placement new, constructing an object at an address that's already allocated
+inline void* operator new(sol::size_t, void* address, sol::internal::placement_tag) noexcept {
+    return address;
+}
@@ -0,0 +1,59 @@
+#pragma once
+/**
+ * Moving lamports between accounts in place, without invoking the System Program
+ *
+ * A program may debit the accounts it owns and credit any writable account by changing their balances directly. The
+ * runtime verifies afterwards that no lamports were created or destroyed. A transfer this way costs a few instructions,
+ * whereas a cross-program invocation of the System Program costs over a thousand compute units.
+ * The System Program still has to move the lamports of accounts the program doesn't own, such as a payer's.
+ *
+ * Example:
+ * if (uint64_t error = transfer_lamports(vault, recipient, fee)) {
+ *     return error;
+ * }
+ *
+ * close_account moves all lamports of an account to another one and returns the account to the System Program with
+ * empty data, so that it can't be used with stale contents within the same transaction. The runtime removes accounts
+ * without lamports at the end of the transaction.
+ */
+
+#include <sol_account.h>
+#include <sol_int.h>
+#include <sol_native.h>
+#include <sol_status_codes.h>
+
+namespace sol {
+
+// debits from and credits to, failing without changing either balance if from holds less than amount or to would
+// overflow
+inline uint64_t transfer_lamports(AccountInfo& from, AccountInfo& to, uint64_t amount) {
+    const uint64_t source = from.lamports();
+    if (source < amount) {
+        return error::INSUFFICIENT_FUNDS;
+    }
+    // debited first, so that a transfer from an account to itself has no effect
+    from.lamports() = Lamports(source - amount);
+    uint64_t destination = 0;
+    if (__builtin_add_overflow(uint64_t(to.lamports()), amount, &destination)) {
+        from.lamports() = Lamports(source);
+        return error::ARITHMETIC_OVERFLOW;
+    }
+    to.lamports() = Lamports(destination);
+    return SUCCESS;
+}
+
+// moves all lamports of the account to destination, then empties its data and assigns it to the System Program
+inline uint64_t close_account(AccountInfo& account, AccountInfo& destination) {
+    if (&account.lamports() == &destination.lamports()) {
+        return error::INVALID_ARGUMENT; // closing an account into itself would keep its lamports
+    }
+    if (const uint64_t error = transfer_lamports(account, destination, account.lamports())) {
+        return error;
+    }
+    // shrinking always succeeds, and with no data left, there's nothing to zero
+    account.realloc(0, false);
+    account.assign(native::SystemProgram::pubkey());
+    return SUCCESS;
+}
+
+} // namespace sol
@@ -16,6 +16,19 @@ constexpr uint64_t MAX_SEEDS = 16;
  */
 constexpr uint64_t MAX_PERMITTED_DATA_INCREASE = 1024 * 10;
 
+/**
+ * Default and maximum size of the heap, starting at HEAP_START (see sol_arena.h)
+ * A larger heap frame can be requested for a transaction, in multiples of 1 KB.
+ */
+constexpr uint64_t HEAP_START = 0x300000000;
+constexpr uint64_t MIN_HEAP_FRAME_BYTES = 32 * 1024;
+constexpr uint64_t MAX_HEAP_FRAME_BYTES = 256 * 1024;
+
+/**
+ * Address of the program's input, i.e. of the serialized accounts and instruction data (see sol_input.h)
+ */
+constexpr uint64_t INPUT_START = 0x400000000;
+
 /**
  * Minimum of signed integral types
  */
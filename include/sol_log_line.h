@@ -0,0 +1,182 @@
+#pragma once
+/**
+ * Formatting a log message on the stack, to be logged with a single syscall
+ *
+ * Every call of log() is a syscall with a base cost, so log("The account", pubkey, "has", len, "bytes.") costs five.
+ * log_line() formats all of its arguments into one line, separated by spaces, and logs it at the cost of one:
+ *
+ * log_line("The account", account.pubkey(), "has", account.data_len(), "bytes of data.");
+ *
+ * A LogLine is the buffer underneath, for building a line piece by piece:
+ *
+ * LogLine<> line;
+ * line << "keys:";
+ * for (uint64_t i = 0; i != count; ++i) {
+ *     line << ' ' << keys[i];
+ * }
+ * line.emit();
+ *
+ * Integers are formatted as decimals, or in hexadecimal when wrapped by hex(). Pubkeys are Base58-encoded.
+ * A line that doesn't fit into the buffer is truncated, ending in "...". Users may format their own types by overloading
+ * operator<< for a LogWriter, as done for AccountInfo, Hash and the sysvars.
+ */
+
+#include <sol_base58.h>
+#include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_memory.h>
+#include <sol_pubkey.h>
+#include <sol_string.h>
+#include <sol_syscalls.h>
+
+namespace sol {
+
+namespace internal {
+
+struct HexInteger {
+    uint64_t value;
+};
+
+} // namespace internal
+
+// formats an integer in hexadecimal, e.g. 0x2a
+template<class T, typename internal::enable_if<internal::is_integer<T>::value, bool>::type = true>
+internal::HexInteger hex(T value) {
+    return {uint64_t(value)};
+}
+
+// Appends formatted values to a buffer, without ever writing past its end
+class LogWriter {
+    char* _buffer;
+    uint64_t _capacity;
+    uint64_t _len;
+    bool _truncated;
+
+public:
+    LogWriter(char* buffer, uint64_t capacity) :
+        _buffer(buffer),
+        _capacity(capacity),
+        _len(0),
+        _truncated(false) {
+    }
+
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    uint64_t len() const {
+        return _len;
+    }
+
+    bool truncated() const {
+        return _truncated;
+    }
+
+    const char* data() const {
+        return _buffer;
+    }
+
+    // discards the contents
+    void clear() {
+        _len = 0;
+        _truncated = false;
+    }
+
+    // appends as many of the characters as fit
+    LogWriter& append(const char* characters, uint64_t len) {
+        if (len > _capacity - _len) {
+            len = _capacity - _len;
+            _truncated = true;
+        }
+        memcpy(_buffer + _len, characters, len);
+        _len += len;
+        return *this;
+    }
+
+    // logs the contents with a single syscall, marking a truncated line by replacing its end with "..."
+    void emit() {
+        if (_truncated && _capacity >= 3) {
+            __builtin_memcpy(_buffer + _capacity - 3, "...", 3);
+        }
+        syscall::sol_log_(_buffer, _len);
+    }
+
+    LogWriter& operator<<(const char* string) {
+        return append(string, strlen(string));
+    }
+
+    LogWriter& operator<<(char character) {
+        return append(&character, 1);
+    }
+
+    LogWriter& operator<<(bool value) {
+        return value ? append("true", 4) : append("false", 5);
+    }
+
+    template<class T, typename internal::enable_if<internal::is_integer<T>::value, bool>::type = true>
+    LogWriter& operator<<(T value) {
+        char digits[20];
+        uint64_t start = sizeof(digits);
+        const bool negative = T(-1) < T(0) && value < 0;
+        // negating in uint64_t keeps INT64_MIN correct
+        uint64_t magnitude = negative ? 0 - uint64_t(value) : uint64_t(value);
+        do {
+            digits[--start] = char('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (negative) {
+            *this << '-';
+        }
+        return append(digits + start, sizeof(digits) - start);
+    }
+
+    LogWriter& operator<<(internal::HexInteger number) {
+        char digits[18];
+        uint64_t start = sizeof(digits);
+        uint64_t value = number.value;
+        do {
+            digits[--start] = "0123456789abcdef"[value & 0xf];
+            value >>= 4;
+        } while (value != 0);
+        digits[--start] = 'x';
+        digits[--start] = '0';
+        return append(digits + start, sizeof(digits) - start);
+    }
+
+    LogWriter& operator<<(Lamports lamports) {
+        return *this << uint64_t(lamports);
+    }
+
+    LogWriter& operator<<(Epoch epoch) {
+        return *this << uint64_t(epoch);
+    }
+
+    LogWriter& operator<<(Slot slot) {
+        return *this << uint64_t(slot);
+    }
+
+    LogWriter& operator<<(const Pubkey& pubkey) {
+        char encoded[MAX_BASE58_PUBKEY_LEN];
+        return append(encoded, to_base58(pubkey, encoded));
+    }
+};
+
+// A LogWriter with a buffer of CAPACITY bytes on the stack
+template<uint64_t CAPACITY = 256>
+class LogLine : public LogWriter {
+    char _storage[CAPACITY];
+
+public:
+    LogLine() : LogWriter(_storage, CAPACITY) {
+    }
+};
+
+// logs the arguments separated by spaces with a single syscall
+template<uint64_t CAPACITY = 256, typename... Ts>
+void log_line(const Ts&... args) {
+    LogLine<CAPACITY> line;
+    bool first = true;
+    ((first ? line << args : line << ' ' << args, first = false), ...);
+    line.emit();
+}
+
+} // namespace sol
@@ -9,15 +9,37 @@
  * The log function is overloaded for a number of types such as Pubkey or AccountInfo.
  * Users may define additional overloads for their custom types.
  * Note that there is a variadic template that calls the single-parameter version of log on each argument.
+ * Each of these calls is a syscall; log_line formats all arguments into a single message instead. (see sol_log_line.h)
+ *
+ * log_error, log_info and log_debug format their arguments like log_line, in a single syscall. They log only if
+ * SOL_LOG_LEVEL is at least their level, and compile to nothing otherwise, taking their string literals out of the program too. SOL_LOG_LEVEL defaults to SOL_LOG_LEVEL_DEBUG, i.e. everything is logged.
+ * Define it before including the SDK, e.g. as SOL_LOG_LEVEL_ERROR for a release build.
+ * Arguments are evaluated regardless of the level, so they shouldn't have side effects.
+ *
+ * fail() logs an error message and returns a custom program error. Below SOL_LOG_LEVEL_ERROR only the numeric code remains:
+ * if (amount > balance) {
+ *     return fail(INSUFFICIENT_BALANCE, "ERROR: Insufficient balance:", balance);
+ * }
  *
  * TODO: Consider renaming log() to print(), to avoid confusion with the logarithm function std::log.
  */
 
 #include <sol_int.h>
 #include <sol_internal.h>
+#include <sol_log_line.h>
+#include <sol_status_codes.h>
 #include <sol_string.h>
 #include <sol_syscalls.h>
 
+#define SOL_LOG_LEVEL_NONE 0
+#define SOL_LOG_LEVEL_ERROR 1
+#define SOL_LOG_LEVEL_INFO 2
+#define SOL_LOG_LEVEL_DEBUG 3
+
+#ifndef SOL_LOG_LEVEL
+#define SOL_LOG_LEVEL SOL_LOG_LEVEL_DEBUG
+#endif
+
 namespace sol {
 
 // log a statically allocated array, the entries of which must all be valid
@@ -47,4 +69,32 @@ void log(const Ts&... args) {
     (log(args), ...);
 }
 
+template<typename... Ts>
+void log_error(const Ts&... args) {
+    if constexpr (SOL_LOG_LEVEL >= SOL_LOG_LEVEL_ERROR) {
+        log_line(args...);
+    }
+}
+
+template<typename... Ts>
+void log_info(const Ts&... args) {
+    if constexpr (SOL_LOG_LEVEL >= SOL_LOG_LEVEL_INFO) {
+        log_line(args...);
+    }
+}
+
+template<typename... Ts>
+void log_debug(const Ts&... args) {
+    if constexpr (SOL_LOG_LEVEL >= SOL_LOG_LEVEL_DEBUG) {
+        log_line(args...);
+    }
+}
+
+// logs the message with log_error and returns the custom program error of the code
+template<typename... Ts>
+uint64_t fail(uint32_t code, const Ts&... message) {
+    log_error(message...);
+    return error::custom(code);
+}
+
 } // namespace sol
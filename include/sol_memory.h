@@ -1,10 +1,41 @@
 #pragma once
 /**
  * Low-level operations on memory and addresses
+ *
+ * memcpy, memmove, memset and memcmp choose between two implementations by size. The syscalls cost a base fee, which
+ * dominates for small regions, so up to SOL_MEM_INLINE_MAX bytes between 8-byte aligned addresses are processed inline,
+ * a word at a time. Sizes known at compile time, e.g. memcpy(&key, data, sizeof(Pubkey)), are unrolled into word moves
+ * up to SOL_MEM_UNROLL_MAX bytes. Unaligned and larger regions go to the syscalls.
+ *
+ * Both limits may be defined before including the SDK; src/memory_benchmark measures the crossover points on-chain. The
+ * defaults follow from the BPF instructions LLVM's BPF backend emits for the loops below, executed per size, against
+ * about 19 units for a syscall (mem_op_base of 15, the call and its arguments) or 22 for memcmp with its result:
+ *
+ *   bytes                       8    16    32    40    64    72    80   128
+ *   memcpy, run-time length    24    36    60    72   108
+ *   memset, run-time length    24    33    51    60    87
+ *   memcmp, run-time length    16    26    46    56    86
+ *   memcpy, constant length     2     4     8    10    16    18    20    32
+ *   memset, constant length     2     3     5     6     9    10    11    17
+ *   memcmp, constant length     4     9    17    21    33    37    41    65
+ *
+ * Loops over a run-time length only pay off for memcmp up to 8 bytes, so SOL_MEM_INLINE_MAX is 8. Unrolled copies are
+ * cheaper up to 72 bytes, fills up to 128 and more, and compares up to 40; SOL_MEM_UNROLL_MAX is 64, which keeps
+ * Pubkeys and most fixed-size records inline. Compares count equal regions. These are instruction counts rather than
+ * measurements of a deployed program, whose compiler may generate different code.
  */
 
+#include <sol_int.h>
 #include <sol_syscalls.h>
 
+#ifndef SOL_MEM_INLINE_MAX
+#define SOL_MEM_INLINE_MAX 8
+#endif
+
+#ifndef SOL_MEM_UNROLL_MAX
+#define SOL_MEM_UNROLL_MAX 64
+#endif
+
 namespace sol {
 
 // returns the nearest address divisible by BYTES, that's larger than or equal to the argument
@@ -20,8 +51,128 @@ constexpr T* aligned(const T* ptr) {
     return reinterpret_cast<T*>(aligned<BYTES>(reinterpret_cast<uint64_t>(ptr)));
 }
 
+namespace internal {
+
+// may alias any other type, as the regions may hold anything
+typedef uint64_t __attribute__((may_alias)) word64;
+typedef uint32_t __attribute__((may_alias)) word32;
+typedef uint16_t __attribute__((may_alias)) word16;
+
+inline bool word_aligned(const void* a, const void* b) {
+    return ((reinterpret_cast<uint64_t>(a) | reinterpret_cast<uint64_t>(b)) & 7) == 0;
+}
+
+// whether a region of len bytes is processed inline, with constant lengths folded by the compiler
+inline bool mem_inline(uint64_t len) {
+    return __builtin_constant_p(len) ? len <= SOL_MEM_UNROLL_MAX : len <= SOL_MEM_INLINE_MAX;
+}
+
+// the following functions require 8-byte aligned addresses
+
+inline void copy_forward(uint8_t* dst, const uint8_t* src, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        *reinterpret_cast<word64*>(dst + i) = *reinterpret_cast<const word64*>(src + i);
+    }
+    if (len & 4) {
+        *reinterpret_cast<word32*>(dst + i) = *reinterpret_cast<const word32*>(src + i);
+        i += 4;
+    }
+    if (len & 2) {
+        *reinterpret_cast<word16*>(dst + i) = *reinterpret_cast<const word16*>(src + i);
+        i += 2;
+    }
+    if (len & 1) {
+        dst[i] = src[i];
+    }
+}
+
+inline void copy_backward(uint8_t* dst, const uint8_t* src, uint64_t len) {
+    uint64_t i = len;
+    while (i % 8 != 0) {
+        --i;
+        dst[i] = src[i];
+    }
+    while (i != 0) {
+        i -= 8;
+        *reinterpret_cast<word64*>(dst + i) = *reinterpret_cast<const word64*>(src + i);
+    }
+}
+
+inline void fill(uint8_t* dst, uint8_t byte, uint64_t len) {
+    const uint64_t word = uint64_t(byte) * 0x0101010101010101ull;
+    uint64_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        *reinterpret_cast<word64*>(dst + i) = word;
+    }
+    if (len & 4) {
+        *reinterpret_cast<word32*>(dst + i) = uint32_t(word);
+        i += 4;
+    }
+    if (len & 2) {
+        *reinterpret_cast<word16*>(dst + i) = uint16_t(word);
+        i += 2;
+    }
+    if (len & 1) {
+        dst[i] = byte;
+    }
+}
+
+// skips equal words, then locates the first difference among the remaining bytes
+inline int32_t compare(const uint8_t* left, const uint8_t* right, uint64_t len) {
+    uint64_t i = 0;
+    while (i + 8 <= len && *reinterpret_cast<const word64*>(left + i) == *reinterpret_cast<const word64*>(right + i)) {
+        i += 8;
+    }
+    for (; i != len; ++i) {
+        if (left[i] != right[i]) {
+            return int32_t(left[i]) - int32_t(right[i]);
+        }
+    }
+    return 0;
+}
+
+} // namespace internal
+
+// copies len bytes between regions that don't overlap
 inline void memcpy(void* dst, const void* src, uint64_t len) {
-    syscall::sol_memcpy_(dst, src, len);
+    if (internal::mem_inline(len) && internal::word_aligned(dst, src)) {
+        internal::copy_forward(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), len);
+    } else {
+        syscall::sol_memcpy_(dst, src, len);
+    }
+}
+
+// copies len bytes between regions that may overlap
+inline void memmove(void* dst, const void* src, uint64_t len) {
+    if (internal::mem_inline(len) && internal::word_aligned(dst, src)) {
+        if (static_cast<const uint8_t*>(dst) <= static_cast<const uint8_t*>(src)) {
+            internal::copy_forward(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), len);
+        } else {
+            internal::copy_backward(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), len);
+        }
+    } else {
+        syscall::sol_memmove_(dst, src, len);
+    }
+}
+
+// sets len bytes to the given value
+inline void memset(void* dst, uint8_t byte, uint64_t len) {
+    if (internal::mem_inline(len) && internal::word_aligned(dst, dst)) {
+        internal::fill(static_cast<uint8_t*>(dst), byte, len);
+    } else {
+        syscall::sol_memset_(dst, byte, len);
+    }
+}
+
+// returns the difference of the first differing bytes, or 0 if the regions are equal
+inline int32_t memcmp(const void* left, const void* right, uint64_t len) {
+    if (internal::mem_inline(len) && internal::word_aligned(left, right)) {
+        return internal::compare(static_cast<const uint8_t*>(left), static_cast<const uint8_t*>(right), len);
+    }
+    int32_t result = 0;
+    syscall::sol_memcmp_(left, right, len, &result);
+    return result;
 }
 
 } // namespace sol
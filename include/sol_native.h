@@ -29,16 +29,17 @@ public:
     ///   1. [WRITE, SIGNER] New account
     class __attribute__((packed)) CreateAccountParams {
         uint32_t tag;
-        Lamports lamports;
+        // GCC can't pack members of non-POD types such as Lamports and Pubkey, so their representations are stored
+        uint64_t lamports;
         uint64_t bytes;
-        Pubkey owner;
+        uint8_t owner[sizeof(Pubkey)];
     
     public:
         CreateAccountParams(Lamports lamports, uint64_t bytes, const Pubkey& owner) :
             tag(0),
             lamports(lamports),
-            bytes(bytes),
-            owner(owner) {
+            bytes(bytes) {
+            __builtin_memcpy(this->owner, &owner, sizeof(Pubkey));
         }
     };
     static_assert(sizeof(CreateAccountParams) == 4 + 8 + 8 + 32);
@@ -49,12 +50,12 @@ public:
     ///   0. [WRITE, SIGNER] Assigned account public key
     class __attribute__((packed)) AssignParams {
         uint32_t tag;
-        Pubkey owner;
+        uint8_t owner[sizeof(Pubkey)];
     
     public:
         AssignParams(const Pubkey& owner) :
-            tag(1),
-            owner(owner) {
+            tag(1) {
+            __builtin_memcpy(this->owner, &owner, sizeof(Pubkey));
         }
     };
     static_assert(sizeof(AssignParams) == 4 + 32);
@@ -66,7 +67,7 @@ public:
     ///   1. [WRITE] Recipient account
     class __attribute__((packed)) TransferParams {
         uint32_t tag;
-        Lamports lamports;
+        uint64_t lamports;
     
     public:
         TransferParams(Lamports lamports) :
@@ -104,7 +105,7 @@ public:
     ///   4. [SIGNER] Nonce authority
     class __attribute__((packed)) WithdrawNonceAccountParams {
         uint32_t tag;
-        Lamports lamports;
+        uint64_t lamports;
     
     public:
         WithdrawNonceAccountParams(Lamports lamports) :
@@ -122,12 +123,12 @@ public:
     ///   2. [] Rent sysvar
     class __attribute__((packed)) InitializeNonceAccountParams {
         uint32_t tag;
-        Pubkey authority;
+        uint8_t authority[sizeof(Pubkey)];
     
     public:
         InitializeNonceAccountParams(const Pubkey& authority) :
-            tag(6),
-            authority(authority) {
+            tag(6) {
+            __builtin_memcpy(this->authority, &authority, sizeof(Pubkey));
         }
     };
     static_assert(sizeof(InitializeNonceAccountParams) == 4 + 32);
@@ -139,12 +140,12 @@ public:
     ///   1. [SIGNER] Nonce authority
     class __attribute__((packed)) AuthorizeNonceAccountParams {
         uint32_t tag;
-        Pubkey authority;
+        uint8_t authority[sizeof(Pubkey)];
     
     public:
         AuthorizeNonceAccountParams(const Pubkey& authority) :
-            tag(7),
-            authority(authority) {
+            tag(7) {
+            __builtin_memcpy(this->authority, &authority, sizeof(Pubkey));
         }
     };
     static_assert(sizeof(AuthorizeNonceAccountParams) == 4 + 32);
@@ -0,0 +1,230 @@
+#pragma once
+/**
+ * Program-derived addresses of constant seeds, computed at compile time
+ *
+ * find_pda_const does what find_pda does, hashing and checking that the address is off the ed25519 curve, but in the compiler.
+ * The program id and all seeds must be constants; seeds may be string literals or Pubkeys. Only a constexpr variable
+ * guarantees evaluation by the compiler, so the result should always initialize one; elsewhere find_pda_const falls
+ * back to the syscall, like find_pda.
+ *
+ * Example:
+ * constexpr Pubkey PROGRAM_ID = from_base58("...");
+ * constexpr FoundPDA CONFIG = find_pda_const(PROGRAM_ID, "config");
+ * constexpr FoundPDA VAULT = find_pda_const(PROGRAM_ID, "vault", native::SystemProgram::pubkey());
+ *
+ * if (config_account.pubkey() != CONFIG.pubkey) {
+ *     return error::INVALID_SEEDS;
+ * }
+ *
+ * As a safety net, check_pda_const compares a constant against the result of the syscall when the program is compiled with
+ * SOL_CHECK_PDA_CONST defined, and panics on a mismatch. Otherwise it does nothing.
+ */
+
+#include <sol_hash.h>
+#include <sol_int.h>
+#include <sol_limits.h>
+#include <sol_logging.h>
+#include <sol_pubkey.h>
+#include <sol_seed.h>
+#include <sol_syscall_wrappers.h>
+
+namespace sol {
+
+namespace internal {
+
+// Arithmetic modulo 2^255 - 19 with five 51-bit limbs, as far as required by is_on_curve(); libsol_host uses it too
+struct ConstFieldElement {
+    uint64_t limbs[5];
+
+    static constexpr uint64_t MASK = (uint64_t(1) << 51) - 1;
+
+    static constexpr ConstFieldElement from_bytes(const uint8_t (&bytes)[32]) {
+        uint64_t words[4] = {};
+        for (int i = 0; i != 4; ++i) {
+            for (int j = 7; j >= 0; --j) {
+                words[i] = words[i] << 8 | bytes[8 * i + j];
+            }
+        }
+        return {{
+            words[0] & MASK,
+            (words[0] >> 51 | words[1] << 13) & MASK,
+            (words[1] >> 38 | words[2] << 26) & MASK,
+            (words[2] >> 25 | words[3] << 39) & MASK,
+            (words[3] >> 12) & MASK, // ignores the sign bit of x
+        }};
+    }
+
+    constexpr ConstFieldElement carry() const {
+        ConstFieldElement r = *this;
+        for (int i = 0; i != 4; ++i) {
+            r.limbs[i + 1] += r.limbs[i] >> 51;
+            r.limbs[i] &= MASK;
+        }
+        r.limbs[0] += (r.limbs[4] >> 51) * 19;
+        r.limbs[4] &= MASK;
+        r.limbs[1] += r.limbs[0] >> 51;
+        r.limbs[0] &= MASK;
+        return r;
+    }
+
+    constexpr ConstFieldElement operator+(const ConstFieldElement& other) const {
+        ConstFieldElement r = {};
+        for (int i = 0; i != 5; ++i) {
+            r.limbs[i] = limbs[i] + other.limbs[i];
+        }
+        return r.carry();
+    }
+
+    constexpr ConstFieldElement operator-(const ConstFieldElement& other) const {
+        // adds 4p to avoid underflow
+        constexpr uint64_t four_p[5] = {
+            0x1fffffffffffb4, 0x1ffffffffffffc, 0x1ffffffffffffc, 0x1ffffffffffffc, 0x1ffffffffffffc
+        };
+        ConstFieldElement r = {};
+        for (int i = 0; i != 5; ++i) {
+            r.limbs[i] = limbs[i] + four_p[i] - other.limbs[i];
+        }
+        return r.carry();
+    }
+
+    constexpr ConstFieldElement operator*(const ConstFieldElement& other) const {
+        typedef unsigned __int128 uint128_t;
+        uint128_t t[5] = {};
+        for (int i = 0; i != 5; ++i) {
+            for (int j = 0; j != 5; ++j) {
+                const uint128_t product = uint128_t(limbs[i]) * other.limbs[j];
+                if (i + j < 5) {
+                    t[i + j] += product;
+                } else {
+                    t[i + j - 5] += product * 19;
+                }
+            }
+        }
+        ConstFieldElement r = {};
+        uint128_t c = 0;
+        for (int i = 0; i != 5; ++i) {
+            t[i] += c;
+            r.limbs[i] = uint64_t(t[i]) & MASK;
+            c = t[i] >> 51;
+        }
+        r.limbs[0] += uint64_t(c) * 19;
+        return r.carry();
+    }
+
+    // compares the fully reduced element to a small integer
+    constexpr bool equals(uint64_t small) const {
+        ConstFieldElement r = carry().carry();
+        const bool ge_p = r.limbs[0] >= MASK - 18 && r.limbs[1] == MASK && r.limbs[2] == MASK &&
+                          r.limbs[3] == MASK && r.limbs[4] == MASK;
+        if (ge_p) {
+            r.limbs[0] -= MASK - 18;
+            r.limbs[1] = r.limbs[2] = r.limbs[3] = r.limbs[4] = 0;
+        }
+        return r.limbs[0] == small && r.limbs[1] == 0 && r.limbs[2] == 0 && r.limbs[3] == 0 && r.limbs[4] == 0;
+    }
+};
+
+// returns whether the bytes are the compressed form of an ed25519 point, i.e. whether x^2 = (y^2 - 1) / (d y^2 + 1) has
+// a solution, which is the case if (y^2 - 1)(d y^2 + 1) is zero or a quadratic residue
+constexpr bool is_on_curve(const uint8_t (&point)[32]) {
+    constexpr ConstFieldElement d = {{
+        929955233495203, 466365720129213, 1662059464998953, 2033849074728123, 1442794654840575
+    }};
+    constexpr ConstFieldElement one = {{1, 0, 0, 0, 0}};
+    const ConstFieldElement y = ConstFieldElement::from_bytes(point);
+    const ConstFieldElement y2 = y * y;
+    const ConstFieldElement t = (y2 - one) * (d * y2 + one);
+    if (t.equals(0)) {
+        return true;
+    }
+    // Euler's criterion: t^((p - 1) / 2) with (p - 1) / 2 = 2^254 - 10
+    ConstFieldElement power = one;
+    for (int bit = 253; bit >= 0; --bit) {
+        power = power * power;
+        if (bit != 3 && bit != 0) {
+            power = power * t;
+        }
+    }
+    return power.equals(1);
+}
+
+// known answers, from Euler's criterion evaluated independently: the base point with y = 4/5 and small y
+constexpr uint8_t BASE_POINT[32] = {
+    0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+    0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+};
+constexpr uint8_t Y_2[32] = {2};
+constexpr uint8_t Y_3[32] = {3};
+constexpr uint8_t Y_7[32] = {7};
+static_assert(is_on_curve(BASE_POINT) && is_on_curve(Y_3) && !is_on_curve(Y_2) && !is_on_curve(Y_7));
+
+template<uint64_t N>
+constexpr void hash_seed(ConstSha256& hasher, const char (&seed)[N]) {
+    static_assert(N - 1 <= MAX_SEED_LEN, "seed too long");
+    hasher.update(seed);
+}
+
+constexpr void hash_seed(ConstSha256& hasher, const Pubkey& seed) {
+    for (uint64_t i = 0; i != Pubkey::LANES; ++i) {
+        const uint64_t lane = seed.lane(i);
+        for (int j = 0; j != 8; ++j) {
+            const uint8_t byte = uint8_t(lane >> (8 * j));
+            hasher.update(&byte, 1);
+        }
+    }
+}
+
+// not constexpr, so that failing to find a bump seed in find_pda_const is a compile error
+inline void no_bump_seed_found() {
+    log_error("ERROR: No bump seed yields a program derived address");
+    sol_panic();
+}
+
+template<uint64_t N>
+SignerSeed signer_seed(const char (&seed)[N]) {
+    return SignerSeed(seed);
+}
+
+inline SignerSeed signer_seed(const Pubkey& seed) {
+    return SignerSeed(seed);
+}
+
+} // namespace internal
+
+// returns the program derived address of constant seeds and its bump seed, like find_pda but at compile time; the
+// result must initialize a constexpr variable, as other calls are evaluated at run time, and thus by the syscall
+template<typename... Ts>
+constexpr FoundPDA find_pda_const(const Pubkey& program_id, const Ts&... seeds) {
+    static_assert(sizeof...(Ts) < MAX_SEEDS, "too many seeds, the bump seed needs another one");
+    if (!__builtin_is_constant_evaluated()) {
+        return find_pda(program_id, internal::signer_seed(seeds)...); // far cheaper than hashing in the program
+    }
+    for (int bump = 255; bump > 0; --bump) {
+        ConstSha256 hasher;
+        (internal::hash_seed(hasher, seeds), ...);
+        const uint8_t bump_seed = uint8_t(bump);
+        hasher.update(&bump_seed, 1);
+        internal::hash_seed(hasher, program_id);
+        hasher.update("ProgramDerivedAddress");
+        const Hash address = hasher.finish();
+        if (!internal::is_on_curve(address.bytes)) {
+            return {Pubkey(address.bytes), bump_seed};
+        }
+    }
+    internal::no_bump_seed_found(); // practically impossible, as each bump seed has a chance of about 1/2
+    return {};
+}
+
+// panics unless pda is what find_pda returns for the seeds, if SOL_CHECK_PDA_CONST is defined
+template<typename... Ts>
+void check_pda_const(const FoundPDA& pda, const Pubkey& program_id, const Ts&... seeds) {
+#ifdef SOL_CHECK_PDA_CONST
+    const FoundPDA found = find_pda(program_id, internal::signer_seed(seeds)...);
+    if (found.pubkey != pda.pubkey || found.bump_seed != pda.bump_seed) {
+        log_error("ERROR: find_pda_const differs from find_pda:", pda.pubkey, found.pubkey);
+        sol_panic();
+    }
+#endif
+}
+
+} // namespace sol
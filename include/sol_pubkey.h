@@ -3,6 +3,7 @@
  * 32-byte public keys
  *
  * Operators for comparison and logging are provided.
+ * Comparisons operate on four 64-bit lanes rather than 32 bytes, and fold to immediate compares against constants.
  * Pubkeys can be created from their Base58 representation. (see sol_base58.h)
  *
  * Example:
@@ -15,34 +16,62 @@
 namespace sol {
 
 class Pubkey {
-    friend bool operator==(const Pubkey& left, const Pubkey& right);
-    friend bool operator<(const Pubkey& left, const Pubkey& right);
     friend constexpr Pubkey from_base58(const char* encoded);
 
+    // permits reading the bytes as 64-bit words without violating strict aliasing; Pubkeys have an alignment of 1 and
+    // occur at any offset in packed parameters and instruction data, so the words may be unaligned too
+    typedef uint64_t __attribute__((may_alias, aligned(1))) lane_t;
+
     uint8_t bytes[32];
 
 public:
+    static constexpr uint64_t LANES = 4;
+
     constexpr Pubkey() : bytes{} {
     }
-};
 
-inline bool operator==(const Pubkey& left, const Pubkey& right) {
-    for (int i = 0; i != sizeof(Pubkey::bytes); ++i) {
-        if (left.bytes[i] != right.bytes[i]) {
-            return false;
+    explicit constexpr Pubkey(const uint8_t (&key)[32]) : bytes{} {
+        for (int i = 0; i != 32; ++i) {
+            bytes[i] = key[i];
+        }
+    }
+
+    // returns 8 bytes of the key as a little-endian word; a single load at run time where unaligned loads are allowed
+    constexpr uint64_t lane(uint64_t index) const {
+        if (__builtin_is_constant_evaluated()) {
+            uint64_t word = 0;
+            for (int i = 7; i >= 0; --i) {
+                word = (word << 8) | bytes[8 * index + i];
+            }
+            return word;
         }
+        return reinterpret_cast<const lane_t*>(bytes)[index];
+    }
+
+    // returns a hash for open addressing, e.g. hash() >> (64 - log2(table size))
+    constexpr uint64_t hash() const {
+        // keys are mostly uniform already, but sysvar and native program ids share long runs of bytes
+        const uint64_t folded = lane(0) ^ (lane(1) + 0x9e3779b97f4a7c15) ^ (lane(2) << 1) ^ (lane(3) >> 1);
+        return folded * 0x9e3779b97f4a7c15;
     }
-    return true;
+};
+
+constexpr bool operator==(const Pubkey& left, const Pubkey& right) {
+    return ((left.lane(0) ^ right.lane(0)) | (left.lane(1) ^ right.lane(1)) |
+            (left.lane(2) ^ right.lane(2)) | (left.lane(3) ^ right.lane(3))) == 0;
 }
 
-inline bool operator!=(const Pubkey& left, const Pubkey& right) {
+constexpr bool operator!=(const Pubkey& left, const Pubkey& right) {
     return !(left == right);
 }
 
-inline bool operator<(const Pubkey& left, const Pubkey& right) {
-    for (int i = 0; i != sizeof(Pubkey::bytes); ++i) {
-        if (left.bytes[i] != right.bytes[i]) {
-            return left.bytes[i] < right.bytes[i];
+// lexicographic order of the bytes, i.e. big-endian order of the lanes
+constexpr bool operator<(const Pubkey& left, const Pubkey& right) {
+    for (uint64_t i = 0; i != Pubkey::LANES; ++i) {
+        const uint64_t l = left.lane(i);
+        const uint64_t r = right.lane(i);
+        if (l != r) {
+            return __builtin_bswap64(l) < __builtin_bswap64(r);
         }
     }
     return false;
@@ -0,0 +1,152 @@
+#pragma once
+/**
+ * Declarative validation of an instruction's accounts
+ *
+ * An Accounts type lists one constraint per expected account. Loading the accounts checks all constraints in a single
+ * pass without early exits, and returns either SUCCESS or the error of the first account that violates its constraint.
+ *
+ * Example:
+ * struct MemoProgram {
+ *     static constexpr Pubkey pubkey() { return from_base58("MemoSq4gqABAXKb96qnH8TysNcWxMyWCqXgDLGmfcHr"); }
+ * };
+ *
+ * using TransferAccounts = Accounts<
+ *     Writable<Signer>,                   // payer
+ *     Writable<Owner<MyProgram>>,         // vault owned by this program
+ *     Program<native::SystemProgram>,
+ *     Program<MemoProgram>
+ * >;
+ *
+ * TransferAccounts accounts;
+ * const uint64_t error = accounts.load(account_infos, accounts_given);
+ * if (error != SUCCESS) {
+ *     return error;
+ * }
+ * AccountInfo& vault = accounts.get<1>();         // writable accounts are returned by non-const reference
+ * const AccountInfo& memo = accounts.get<3>();    // all others by const reference
+ *
+ * Available constraints are Any, Signer, Writable<C>, Owner<P, C>, RentExempt<C> and Program<P>, where P is a class with a static
+ * constexpr pubkey() function such as native::SystemProgram, and C is a nested constraint. Users may define their own
+ * constraints with the same static members.
+ * Program-derived addresses depend on seeds, so they're verified separately. (see sol_syscall_wrappers.h)
+ */
+
+#include <sol_account.h>
+#include <sol_int.h>
+#include <sol_internal.h>
+#include <sol_pubkey.h>
+#include <sol_status_codes.h>
+#include <sol_sysvar_cache.h>
+
+namespace sol {
+
+// No requirements
+struct Any {
+    static constexpr bool writable = false;
+
+    static uint64_t check(const AccountInfo&) {
+        return SUCCESS;
+    }
+};
+
+// The transaction was signed by the account
+struct Signer {
+    static constexpr bool writable = false;
+
+    static uint64_t check(const AccountInfo& account) {
+        return !account.is_signer() * error::MISSING_REQUIRED_SIGNATURES;
+    }
+};
+
+// The account is writable and satisfies the nested constraint
+template<class C = Any>
+struct Writable {
+    static constexpr bool writable = true;
+
+    static uint64_t check(const AccountInfo& account) {
+        return internal::first_nonzero(!account.is_writable() * error::INVALID_ARGUMENT, C::check(account));
+    }
+};
+
+// The account is owned by program P and satisfies the nested constraint
+template<class P, class C = Any>
+struct Owner {
+    static constexpr bool writable = C::writable;
+
+    static uint64_t check(const AccountInfo& account) {
+        constexpr Pubkey owner = P::pubkey();
+        return internal::first_nonzero((account.owner() != owner) * error::INCORRECT_PROGRAM_ID, C::check(account));
+    }
+};
+
+// The account holds the rent-exempt minimum balance for its data and satisfies the nested constraint
+template<class C = Any>
+struct RentExempt {
+    static constexpr bool writable = C::writable;
+
+    static uint64_t check(const AccountInfo& account) {
+        return internal::first_nonzero(!is_rent_exempt(account) * error::ACCOUNT_NOT_RENT_EXEMPT, C::check(account));
+    }
+};
+
+// The account is program P
+template<class P>
+struct Program {
+    static constexpr bool writable = false;
+
+    static uint64_t check(const AccountInfo& account) {
+        constexpr Pubkey program_id = P::pubkey();
+        return (account.pubkey() != program_id) * error::INCORRECT_PROGRAM_ID;
+    }
+};
+
+// References the accounts of an instruction after checking them against the constraints Cs, one per account.
+template<class... Cs>
+class Accounts {
+    static_assert(sizeof...(Cs) > 0, "at least one account must be expected");
+
+    AccountInfo* _accounts[sizeof...(Cs)];
+
+    template<uint64_t... Is>
+    uint64_t check(internal::index_sequence<Is...>) const {
+        uint64_t error = SUCCESS;
+        ((error = internal::first_nonzero(error, Cs::check(*_accounts[Is]))), ...);
+        return error;
+    }
+
+public:
+    static constexpr uint64_t size() {
+        return sizeof...(Cs);
+    }
+
+    // references the first size() accounts and returns SUCCESS if they satisfy their constraints, or an error otherwise
+    template<uint64_t ACCOUNTS>
+    uint64_t load(AccountInfo (&account_infos)[ACCOUNTS], uint64_t accounts_given) {
+        static_assert(ACCOUNTS >= sizeof...(Cs), "the AccountInfo array is too small for the expected accounts");
+        return load(static_cast<AccountInfo*>(account_infos), accounts_given);
+    }
+
+    // load() for an array of accounts_given AccountInfos, e.g. one allocated by deserialize() (see sol_serialization.h)
+    uint64_t load(AccountInfo* account_infos, uint64_t accounts_given) {
+        if (accounts_given < sizeof...(Cs)) {
+            return error::NOT_ENOUGH_ACCOUNT_KEYS;
+        }
+        for (uint64_t i = 0; i != sizeof...(Cs); ++i) {
+            _accounts[i] = &account_infos[i];
+        }
+        return check(internal::make_index_sequence<sizeof...(Cs)>());
+    }
+
+    // returns the account at index I, by const reference unless it was required to be writable
+    template<uint64_t I>
+    typename internal::conditional<
+        internal::type_at<I, Cs...>::type::writable,
+        AccountInfo&,
+        const AccountInfo&
+    >::type get() const {
+        static_assert(I < sizeof...(Cs), "account index out of range");
+        return *_accounts[I];
+    }
+};
+
+} // namespace sol
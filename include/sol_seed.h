@@ -58,7 +58,7 @@ public:
         addr(reinterpret_cast<const uint8_t*>(addr)),
         len(bytes) {
         if (len > MAX_SEED_LEN) {
-            log("ERROR: Seed too long");
+            log_error("ERROR: Seed too long");
             sol_panic();
         }
     }
@@ -68,8 +68,7 @@ public:
         addr(reinterpret_cast<const uint8_t*>(string)),
         len(strlen(string)) {
         if (len > MAX_SEED_LEN) {
-            log("ERROR: Seed too long:");
-            log(string);
+            log_error("ERROR: Seed too long:", string);
             sol_panic();
         }
     }
@@ -80,7 +79,7 @@ public:
         addr(SeedConstructor<T>::addr(object)),
         len(SeedConstructor<T>::len(object)) {
         if (len > MAX_SEED_LEN) {
-            log("ERROR: Seed too long");
+            log_error("ERROR: Seed too long");
             sol_panic();
         }
     }
@@ -4,6 +4,18 @@
  *
  * The call to deserialize() will look roughly the same in every program.
  * All parameters except for the first are out-parameters.
+ * Programs that only read a few of the accounts they're given may use an InputView instead. (see sol_input.h)
+ *
+ * The AccountInfo array may be on the stack, holding up to as many accounts as it has elements, or be allocated on the
+ * heap for exactly the accounts given. At 56 bytes per AccountInfo, the latter keeps large account lists from
+ * exhausting the 4 KB stack frame:
+ *
+ * AccountInfo* accounts = nullptr;
+ * if (!deserialize(input, accounts, accounts_given, instruction_data, instruction_data_len, program_id)) {
+ *     return error::INVALID_ARGUMENT;
+ * }
+ *
+ * An Arena may be passed after the input to allocate from a region other than the default heap. (see sol_arena.h)
  *
  * Example:
  * #include <solana_cpp_sdk.h>
@@ -27,11 +39,98 @@
  * }
  */
 
+#include <sol_account.h>
+#include <sol_arena.h>
+#include <sol_int.h>
 #include <sol_limits.h>
 #include <sol_memory.h>
 
 namespace sol {
 
+namespace internal {
+
+// Reads the serialized accounts of the input one at a time
+class AccountParser {
+public:
+    // fills account_infos[index] from the account at input and returns the position of the next one; a duplicate
+    // copies the AccountInfo of its first occurrence, which must have been parsed before
+    static const uint8_t* parse(const uint8_t* input, AccountInfo* account_infos, uint64_t index) {
+        const uint8_t dup_info = *input;
+        input += sizeof(uint8_t);
+        AccountInfo& account = account_infos[index];
+        if (dup_info != UINT8_MAX) {
+            account = account_infos[dup_info];
+            return input + 7; // padding
+        }
+
+        account._is_signer = *input != 0;
+        input += sizeof(uint8_t);
+
+        account._is_writable = *input != 0;
+        input += sizeof(uint8_t);
+
+        account._executable = *input != 0;
+        input += sizeof(uint8_t);
+
+        input += 4; // padding
+
+        account._pubkey = (Pubkey*) input;
+        input += sizeof(Pubkey);
+
+        account._owner = (Pubkey*) input;
+        input += sizeof(Pubkey);
+
+        account._lamports = (Lamports*) input;
+        input += sizeof(Lamports);
+
+        // account data
+        account._data_len = *(uint64_t*) input;
+        input += sizeof(uint64_t);
+        account._data = (uint8_t*) input;
+        input += internal::original_data_len(input);
+        input += MAX_PERMITTED_DATA_INCREASE;
+        input = aligned<8>(input);
+
+        account._rent_epoch = *(Epoch*) input;
+        input += sizeof(Epoch);
+        return input;
+    }
+
+    // returns the position of the account following the one at input
+    static const uint8_t* skip(const uint8_t* input) {
+        if (*input != UINT8_MAX) {
+            return input + 8;
+        }
+        input += 8; // dup_info, flags and padding
+        input += sizeof(Pubkey);
+        input += sizeof(Pubkey);
+        input += sizeof(Lamports);
+        input += sizeof(uint64_t);
+        input += internal::original_data_len(input);
+        input += MAX_PERMITTED_DATA_INCREASE;
+        input = aligned<8>(input);
+        return input + sizeof(Epoch);
+    }
+
+    // reads the instruction data and the program id following the accounts
+    static void parse_trailer(
+        const uint8_t* input,
+        const uint8_t* (&instruction_data),
+        uint64_t& instruction_data_len,
+        const Pubkey* (&program_id)
+    ) {
+        instruction_data_len = *(uint64_t*) input;
+        input += sizeof(uint64_t);
+        instruction_data = input;
+        input += instruction_data_len;
+
+        program_id = (Pubkey*) input;
+    }
+};
+
+} // namespace internal
+
+// deserializes up to MAX_ACCOUNTS_EXPECTED accounts into the array; accounts beyond that are skipped
 template<uint64_t MAX_ACCOUNTS_EXPECTED>
 bool deserialize(
     const uint8_t* input,
@@ -47,84 +146,58 @@ bool deserialize(
     accounts_given = *(uint64_t*)input;
     input += sizeof(uint64_t);
 
-    for (int i = 0; i < accounts_given; ++i) {
-        uint8_t dup_info = input[0];
-        input += sizeof(uint8_t);
-
-        if (i >= MAX_ACCOUNTS_EXPECTED) {
-            if (dup_info == UINT8_MAX) {
-                input += sizeof(uint8_t);
-                input += sizeof(uint8_t);
-                input += sizeof(uint8_t);
-                input += 4; // padding
-                input += sizeof(Pubkey);
-                input += sizeof(Pubkey);
-                input += sizeof(Lamports);
-                uint64_t data_len = *(uint64_t*) input;
-                input += sizeof(uint64_t);
-                input += data_len;
-                input += MAX_PERMITTED_DATA_INCREASE;
-                input = aligned<8>(input);
-                input += sizeof(Epoch);
-            } else {
-                input += 7; // padding
-            }
-            continue;
-        }
-        if (dup_info == UINT8_MAX) {
-            account_infos[i]._is_signer = *(uint8_t*) input != 0;
-            input += sizeof(uint8_t);
-
-            account_infos[i]._is_writable = *(uint8_t*) input != 0;
-            input += sizeof(uint8_t);
-
-            account_infos[i]._executable = *(uint8_t*) input;
-            input += sizeof(uint8_t);
-
-            input += 4; // padding
-
-            account_infos[i]._pubkey = (Pubkey*) input;
-            input += sizeof(Pubkey);
-
-            account_infos[i]._owner = (Pubkey*) input;
-            input += sizeof(Pubkey);
-
-            account_infos[i]._lamports = (Lamports*) input;
-            input += sizeof(Lamports);
-
-            // account data
-            account_infos[i]._data_len = *(uint64_t*) input;
-            input += sizeof(uint64_t);
-            account_infos[i]._data = (uint8_t*) input;
-            input += account_infos[i]._data_len;
-            input += MAX_PERMITTED_DATA_INCREASE;
-            input = aligned<8>(input);
-
-            account_infos[i]._rent_epoch = *(Epoch*) input;
-            input += sizeof(Epoch);
+    for (uint64_t i = 0; i < accounts_given; ++i) {
+        if (i < MAX_ACCOUNTS_EXPECTED) {
+            input = internal::AccountParser::parse(input, account_infos, i);
         } else {
-            account_infos[i]._is_signer = account_infos[dup_info]._is_signer;
-            account_infos[i]._is_writable = account_infos[dup_info]._is_writable;
-            account_infos[i]._executable = account_infos[dup_info]._executable;
-            account_infos[i]._pubkey = account_infos[dup_info]._pubkey;
-            account_infos[i]._owner = account_infos[dup_info]._owner;
-            account_infos[i]._lamports = account_infos[dup_info]._lamports;
-            account_infos[i]._data_len = account_infos[dup_info]._data_len;
-            account_infos[i]._data = account_infos[dup_info]._data;
-            account_infos[i]._rent_epoch = account_infos[dup_info]._rent_epoch;
-            input += 7; // padding
+            input = internal::AccountParser::skip(input);
         }
     }
 
-    instruction_data_len = *(uint64_t*) input;
+    internal::AccountParser::parse_trailer(input, instruction_data, instruction_data_len, program_id);
+    return true;
+}
+
+// deserializes all accounts into an array of accounts_given AccountInfos, allocated from the arena
+inline bool deserialize(
+    const uint8_t* input,
+    Arena& arena,
+    AccountInfo* (&account_infos),
+    uint64_t& accounts_given,
+    const uint8_t* (&instruction_data),
+    uint64_t& instruction_data_len,
+    const Pubkey* (&program_id)
+) {
+    if (input == nullptr) {
+        return false;
+    }
+    accounts_given = *(uint64_t*)input;
     input += sizeof(uint64_t);
-    instruction_data = input;
-    input += instruction_data_len;
 
-    program_id = (Pubkey*) input;
-    input += sizeof(Pubkey);
+    // uninitialized, as every element is assigned below
+    if (accounts_given > UINT64_MAX / sizeof(AccountInfo)) {
+        return false;
+    }
+    account_infos = static_cast<AccountInfo*>(arena.allocate(sizeof(AccountInfo) * accounts_given, alignof(AccountInfo)));
+    for (uint64_t i = 0; i < accounts_given; ++i) {
+        input = internal::AccountParser::parse(input, account_infos, i);
+    }
 
+    internal::AccountParser::parse_trailer(input, instruction_data, instruction_data_len, program_id);
     return true;
 }
 
+// deserializes all accounts into an array on the heap (see Arena)
+inline bool deserialize(
+    const uint8_t* input,
+    AccountInfo* (&account_infos),
+    uint64_t& accounts_given,
+    const uint8_t* (&instruction_data),
+    uint64_t& instruction_data_len,
+    const Pubkey* (&program_id)
+) {
+    Arena arena;
+    return deserialize(input, arena, account_infos, accounts_given, instruction_data, instruction_data_len, program_id);
+}
+
 } // namespace sol
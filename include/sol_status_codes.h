@@ -34,6 +34,15 @@ constexpr uint64_t NOT_ENOUGH_ACCOUNT_KEYS = to_builtin<11>();
 constexpr uint64_t ACCOUNT_BORROW_FAILED = to_builtin<12>();
 constexpr uint64_t MAX_SEED_LENGTH_EXCEEDED = to_builtin<13>();
 constexpr uint64_t INVALID_SEEDS = to_builtin<14>();
+constexpr uint64_t BORSH_IO_ERROR = to_builtin<15>();
+constexpr uint64_t ACCOUNT_NOT_RENT_EXEMPT = to_builtin<16>();
+constexpr uint64_t INVALID_REALLOC = to_builtin<20>();
+constexpr uint64_t ARITHMETIC_OVERFLOW = to_builtin<24>();
+
+// returns a program-defined error, which is CUSTOM_ZERO for 0 since that would be SUCCESS otherwise
+constexpr uint64_t custom(uint32_t code) {
+    return code != 0 ? code : CUSTOM_ZERO;
+}
 
 } // namespace error
 } // namespace sol
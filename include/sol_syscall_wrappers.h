@@ -11,7 +11,17 @@
  *
  * Similarly, create_pda takes any number of seeds and returns in is_valid whether the derived key can be signed for in a cross-program invocation.
  *
- * invoke_signed does the cross-program invocation.
+ * find_pda may hash up to 255 candidate bump seeds. Once the bump seed is known, e.g. because it was stored in the account's data
+ * when the account was created, verify_pda checks an address with a single hash instead.
+ *
+ * For constant seeds, find_pda_const computes the address at compile time. (see sol_pda.h)
+ *
+ * Example:
+ * if (!verify_pda(vault.pubkey(), program_id, stored_bump_seed, "vault", SignerSeed(owner))) {
+ *     return error::INVALID_SEEDS;
+ * }
+ *
+ * invoke_signed does the cross-program invocation, with an array of AccountInfos or a pointer to a table and its length.
  *
  * Example:
  * invoke_signed(create_account_instruction, account_infos, {
@@ -20,11 +30,19 @@
  * });
  */
 
+#include <sol_account.h>
 #include <sol_int.h>
+#include <sol_logging.h>
+#include <sol_pubkey.h>
 #include <sol_status_codes.h>
 #include <sol_syscalls.h>
 
+#if SOL_LOG_LEVEL >= SOL_LOG_LEVEL_ERROR
 #define sol_panic() ::sol::syscall::sol_panic_(__FILE__, sizeof(__FILE__), __LINE__, 0)
+#else
+// without error messages, the file names are left out of the program too
+#define sol_panic() ::sol::syscall::sol_panic_("", 0, __LINE__, 0)
+#endif
 
 namespace sol {
 
@@ -38,7 +56,7 @@ FoundPDA find_pda(const Pubkey& program_id, const Ts&... seeds) {
     SignerSeed seed_array[sizeof...(Ts)] = { seeds... };
     FoundPDA result;
     if (syscall::sol_try_find_program_address(seed_array, sizeof...(Ts), &program_id, &result.pubkey, &result.bump_seed) != SUCCESS) {
-        log("ERROR: Could not create a program derived address.");
+        log_error("ERROR: Could not create a program derived address.");
         sol_panic();
     }
     return result;
@@ -57,13 +75,40 @@ CreatedPDA create_pda(const Pubkey& program_id, const Ts&... seeds) {
     return result;
 }
 
+// returns whether address is the program derived address of the seeds followed by the bump seed
+template<typename... Ts>
+bool verify_pda(const Pubkey& address, const Pubkey& program_id, const uint8_t& bump_seed, const Ts&... seeds) {
+    SignerSeed seed_array[sizeof...(Ts) + 1] = { seeds..., {&bump_seed, 1} };
+    Pubkey derived;
+    if (syscall::sol_create_program_address(seed_array, sizeof...(Ts) + 1, &program_id, &derived) != SUCCESS) {
+        return false;
+    }
+    return derived == address;
+}
+
+namespace internal {
+
+// the cross-program invocation syscall, with the AccountInfos' data lengths brought up to date (see AccountInfo::realloc)
+inline uint64_t invoke_signed_c(
+    const Instruction& instruction,
+    const AccountInfo* account_infos,
+    uint64_t account_infos_len,
+    const SignerSeeds* signer_seeds,
+    uint64_t signers
+) {
+    refresh_data_lens(account_infos, account_infos_len);
+    return syscall::sol_invoke_signed_c(&instruction, account_infos, account_infos_len, signer_seeds, signers);
+}
+
+} // namespace internal
+
 template<uint64_t ACCOUNTS, uint64_t SIGNERS>
 uint64_t invoke_signed(
   const Instruction& instruction,
   const AccountInfo (&account_info_array)[ACCOUNTS],
   const SignerSeeds (&signer_seeds_array)[SIGNERS]
 ) {
-    return syscall::sol_invoke_signed_c(&instruction, account_info_array, ACCOUNTS, signer_seeds_array, SIGNERS);
+    return internal::invoke_signed_c(instruction, account_info_array, ACCOUNTS, signer_seeds_array, SIGNERS);
 }
 
 template<uint64_t ACCOUNTS>
@@ -71,7 +116,23 @@ uint64_t invoke(
   const Instruction& instruction,
   const AccountInfo (&account_info_array)[ACCOUNTS]
 ) {
-    return syscall::sol_invoke_signed_c(&instruction, account_info_array, ACCOUNTS, nullptr, 0);
+    return internal::invoke_signed_c(instruction, account_info_array, ACCOUNTS, nullptr, 0);
+}
+
+// invoke_signed with the first account_infos_len AccountInfos of a table, e.g. the one deserialized onto the heap
+template<uint64_t SIGNERS>
+uint64_t invoke_signed(
+  const Instruction& instruction,
+  const AccountInfo* account_infos,
+  uint64_t account_infos_len,
+  const SignerSeeds (&signer_seeds_array)[SIGNERS]
+) {
+    return internal::invoke_signed_c(instruction, account_infos, account_infos_len, signer_seeds_array, SIGNERS);
+}
+
+// invoke with the first account_infos_len AccountInfos of a table, e.g. the one deserialized onto the heap
+inline uint64_t invoke(const Instruction& instruction, const AccountInfo* account_infos, uint64_t account_infos_len) {
+    return internal::invoke_signed_c(instruction, account_infos, account_infos_len, nullptr, 0);
 }
 
 } // namespace sol
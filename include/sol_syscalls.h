@@ -29,6 +29,7 @@ void sol_log_(const char*, uint64_t);
 void sol_log_64_(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t);
 void sol_log_compute_units_();
 void sol_log_pubkey(const Pubkey* pubkey);
+void sol_log_data(const Bytes* data, uint64_t data_len);
 
 void* sol_alloc_free_(uint64_t size, void* ptr);
 
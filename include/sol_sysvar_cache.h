@@ -0,0 +1,104 @@
+#pragma once
+/**
+ * Sysvars fetched at most once per program invocation
+ *
+ * Each construction of sysvar::Clock(), Rent() or EpochSchedule() is a syscall that copies the sysvar. A SysvarCache
+ * fetches each sysvar on first use instead and returns const references to the copy, so that any number of helper
+ * functions may ask for the same sysvar without passing it around:
+ *
+ * const sysvar::Clock& clock = SysvarCache().clock();
+ * if (account.lamports() < minimum_balance(account.data_len())) {  // fetches Rent, unless it's cached already
+ *     return error::ACCOUNT_NOT_RENT_EXEMPT;
+ * }
+ *
+ * Programs can't have mutable global variables, so like an Arena the cache keeps its state on the heap, namely in the
+ * last SYSVAR_CACHE_BYTES of the heap, which the default Arena leaves out. The heap is zero-initialized for every
+ * invocation, which marks all sysvars as not yet fetched. SysvarCache objects are thus cheap to construct, and all of
+ * them share the same sysvars.
+ */
+
+#include <sol_account.h>
+#include <sol_arena.h>
+#include <sol_int.h>
+#include <sol_syscalls.h>
+#include <sol_sysvars.h>
+
+namespace sol {
+
+class SysvarCache {
+    enum Flag : uint64_t {
+        CLOCK = 1,
+        EPOCH_SCHEDULE = 2,
+        RENT = 4,
+        RENT_EXEMPTION = 8,
+    };
+
+    // raw storage, since the sysvars' constructors would fetch them
+    struct Storage {
+        uint64_t fetched; // Flags of the sysvars present
+        alignas(8) uint8_t clock[sizeof(sysvar::Clock)];
+        alignas(8) uint8_t epoch_schedule[sizeof(sysvar::EpochSchedule)];
+        alignas(8) uint8_t rent[sizeof(sysvar::Rent)];
+        alignas(8) uint8_t rent_exemption[sizeof(sysvar::RentExemption)];
+    };
+
+    static_assert(sizeof(Storage) <= SYSVAR_CACHE_BYTES, "SysvarCache exceeds its space on the heap");
+
+    Storage& _storage;
+
+    // returns whether the flag was set, setting it
+    bool fetched(Flag flag) const {
+        const bool fetched = (_storage.fetched & flag) != 0;
+        _storage.fetched |= flag;
+        return fetched;
+    }
+
+public:
+    SysvarCache() :
+        _storage(*reinterpret_cast<Storage*>(heap_start() + SOL_HEAP_SIZE - SYSVAR_CACHE_BYTES)) {
+    }
+
+    const sysvar::Clock& clock() const {
+        sysvar::Clock* clock = reinterpret_cast<sysvar::Clock*>(_storage.clock);
+        if (!fetched(CLOCK)) {
+            syscall::sol_get_clock_sysvar(clock);
+        }
+        return *clock;
+    }
+
+    const sysvar::EpochSchedule& epoch_schedule() const {
+        sysvar::EpochSchedule* epoch_schedule = reinterpret_cast<sysvar::EpochSchedule*>(_storage.epoch_schedule);
+        if (!fetched(EPOCH_SCHEDULE)) {
+            syscall::sol_get_epoch_schedule_sysvar(epoch_schedule);
+        }
+        return *epoch_schedule;
+    }
+
+    const sysvar::Rent& rent() const {
+        sysvar::Rent* rent = reinterpret_cast<sysvar::Rent*>(_storage.rent);
+        if (!fetched(RENT)) {
+            syscall::sol_get_rent_sysvar(rent);
+        }
+        return *rent;
+    }
+
+    // the Rent sysvar's exemption threshold, converted once (see sysvar::RentExemption)
+    const sysvar::RentExemption& rent_exemption() const {
+        sysvar::RentExemption* rent_exemption = reinterpret_cast<sysvar::RentExemption*>(_storage.rent_exemption);
+        if (!fetched(RENT_EXEMPTION)) {
+            new (rent_exemption, internal::placement_tag()) sysvar::RentExemption(rent().exemption());
+        }
+        return *rent_exemption;
+    }
+};
+
+// the minimum balance for an account with data_len bytes to be rent-exempt, according to the cached Rent sysvar
+inline Lamports minimum_balance(uint64_t data_len) {
+    return SysvarCache().rent_exemption().minimum_balance(data_len);
+}
+
+inline bool is_rent_exempt(const AccountInfo& account) {
+    return account.lamports() >= minimum_balance(account.data_len());
+}
+
+} // namespace sol
@@ -3,7 +3,7 @@
  * Sysvars for accessing cluster state
  *
  * These are constructed from an AccountInfo, or via a syscall when the parameterless constructor is used.
- * The object contains a copy of the data in either case.
+ * The object contains a copy of the data in either case. A SysvarCache fetches each sysvar only once. (see sol_sysvar_cache.h)
  *
  * Example:
  * log(sysvar::Clock().unix_timestamp());
@@ -14,6 +14,7 @@
 #include <sol_account.h>
 #include <sol_base58.h>
 #include <sol_int.h>
+#include <sol_log_line.h>
 #include <sol_logging.h>
 #include <sol_memory.h>
 #include <sol_syscalls.h>
@@ -38,8 +39,7 @@ public:
 
     Clock(const AccountInfo& account) {
         if (account.pubkey() != pubkey()) {
-            log("ERROR: Wrong account passed to Clock constructor:");
-            log(account.pubkey());
+            log_error("ERROR: Wrong account passed to Clock constructor:", account.pubkey());
             sol_panic();
         }
         memcpy(this, account.data(), sizeof(*this));
@@ -85,8 +85,7 @@ public:
 
     EpochSchedule(const AccountInfo& account) {
         if (account.pubkey() != pubkey()) {
-            log("ERROR: Wrong account passed to EpochSchedule constructor:");
-            log(account.pubkey());
+            log_error("ERROR: Wrong account passed to EpochSchedule constructor:", account.pubkey());
             sol_panic();
         }
         memcpy(this, account.data(), sizeof(*this));
@@ -114,13 +113,122 @@ public:
     }
 };
 
+// The rent exemption of accounts in integer arithmetic
+//
+// The runtime computes the minimum balance as ((128 + data_len) * lamports_per_byte_year) as f64 * exemption_threshold,
+// truncated to u64. Floating-point operations are emulated in software on BPF, so the threshold is decomposed once into
+// an integer mantissa and a power of two instead. The products are rounded to 53 significant bits like f64 values, so
+// the results are exactly those of the runtime, and are available at compile time for known parameters:
+//
+// constexpr RentExemption rent(Lamports(3480), 2.0);
+// static_assert(rent.minimum_balance(0) == 890880);
+class RentExemption {
+    struct Float {
+        uint64_t mantissa; // at most 53 significant bits
+        int64_t exponent;
+    };
+
+    uint64_t _lamports_per_byte_year = 0;
+    uint64_t _mantissa = 0; // the threshold is _mantissa * 2^_exponent, with an odd or zero _mantissa
+    int64_t _exponent = 0;
+
+    static constexpr uint64_t account_storage_overhead = 128;
+    static constexpr int64_t INFINITE_EXPONENT = 2048;
+
+    // the 128-bit product of two 64-bit numbers
+    static constexpr void multiply(uint64_t a, uint64_t b, uint64_t& high, uint64_t& low) {
+        const uint64_t a_low = a & 0xffffffff, a_high = a >> 32;
+        const uint64_t b_low = b & 0xffffffff, b_high = b >> 32;
+        const uint64_t low_low = a_low * b_low;
+        const uint64_t middle = (low_low >> 32) + (a_high * b_low & 0xffffffff) + a_low * b_high;
+        low = (middle << 32) | (low_low & 0xffffffff);
+        high = a_high * b_high + (a_high * b_low >> 32) + (middle >> 32);
+    }
+
+    static constexpr bool bit(uint64_t high, uint64_t low, int index) {
+        return (index < 64 ? low >> index : high >> (index - 64)) & 1;
+    }
+
+    // whether any of the bits below index are set
+    static constexpr bool any_below(uint64_t high, uint64_t low, int index) {
+        if (index <= 64) {
+            return index == 64 ? low != 0 : (low & ((uint64_t(1) << index) - 1)) != 0;
+        }
+        return low != 0 || (high & ((uint64_t(1) << (index - 64)) - 1)) != 0;
+    }
+
+    // rounds (high:low) * 2^exponent to 53 significant bits, ties to even, like a conversion to f64
+    static constexpr Float round(uint64_t high, uint64_t low, int64_t exponent) {
+        const int bits = high != 0 ? 128 - __builtin_clzll(high) : low != 0 ? 64 - __builtin_clzll(low) : 0;
+        if (bits <= 53) {
+            return {low, exponent};
+        }
+        int shift = bits - 53;
+        uint64_t mantissa = shift >= 64 ? high >> (shift - 64) : low >> shift | high << (64 - shift);
+        if (bit(high, low, shift - 1) && (any_below(high, low, shift - 1) || (mantissa & 1) != 0)) {
+            if (++mantissa == uint64_t(1) << 53) {
+                mantissa >>= 1;
+                ++shift;
+            }
+        }
+        return {mantissa, exponent + shift};
+    }
+
+public:
+    constexpr RentExemption(Lamports lamports_per_byte_year, double exemption_threshold) :
+        _lamports_per_byte_year(lamports_per_byte_year) {
+        const uint64_t bits = __builtin_bit_cast(uint64_t, exemption_threshold);
+        const uint64_t fraction = bits & ((uint64_t(1) << 52) - 1);
+        const int64_t biased_exponent = int64_t(bits >> 52 & 0x7ff);
+        if (bits >> 63 != 0 || (biased_exponent == 0x7ff && fraction != 0)) {
+            return; // negative thresholds and NaN yield 0, as f64 to u64 conversions saturate
+        }
+        if (biased_exponent == 0x7ff) {
+            _mantissa = 1;
+            _exponent = INFINITE_EXPONENT;
+        } else if (biased_exponent == 0) {
+            _mantissa = fraction; // subnormal
+            _exponent = -1074;
+        } else {
+            _mantissa = fraction | uint64_t(1) << 52;
+            _exponent = biased_exponent - 1075;
+        }
+        if (_mantissa != 0) {
+            const int zeros = __builtin_ctzll(_mantissa);
+            _mantissa >>= zeros;
+            _exponent += zeros;
+        }
+    }
+
+    constexpr Lamports lamports_per_byte_year() const {
+        return Lamports(_lamports_per_byte_year);
+    }
+
+    constexpr Lamports minimum_balance(uint64_t data_len) const {
+        const uint64_t base = (account_storage_overhead + data_len) * _lamports_per_byte_year;
+        if (base == 0 || _mantissa == 0) {
+            return Lamports(0);
+        }
+        // base as f64, times the threshold, rounded to f64 and truncated
+        const Float rounded_base = round(0, base, 0);
+        uint64_t high = 0, low = 0;
+        multiply(rounded_base.mantissa, _mantissa, high, low);
+        const Float product = round(high, low, rounded_base.exponent + _exponent);
+        if (product.exponent >= 0) {
+            if (product.exponent >= 64 || product.mantissa > ~uint64_t(0) >> product.exponent) {
+                return Lamports(~uint64_t(0));
+            }
+            return Lamports(product.mantissa << product.exponent);
+        }
+        return Lamports(product.exponent <= -64 ? 0 : product.mantissa >> -product.exponent);
+    }
+};
+
 class Rent {
     Lamports _lamports_per_byte_year;  // rental rate
     double _exemption_threshold;       // exemption threshold, in years
     uint8_t _burn_percent;             // what percentage of collected rent is to be destroyed
 
-    static constexpr uint64_t account_storage_overhead = 128;
-
 public:
     static constexpr Pubkey pubkey() {
         return from_base58("SysvarRent111111111111111111111111111111111");
@@ -132,8 +240,7 @@ public:
 
     Rent(const AccountInfo& account) {
         if (account.pubkey() != pubkey()) {
-            log("ERROR: Wrong account passed to Rent constructor:");
-            log(account.pubkey());
+            log_error("ERROR: Wrong account passed to Rent constructor:", account.pubkey());
             sol_panic();
         }
         memcpy(this, account.data(), sizeof(*this));
@@ -151,8 +258,14 @@ public:
         return _burn_percent;
     }
 
+    // the minimum balance computation, with the threshold converted once for repeated use
+    RentExemption exemption() const {
+        return RentExemption(_lamports_per_byte_year, _exemption_threshold);
+    }
+
+    // computed in integer arithmetic, exactly like the runtime's floating-point computation
     Lamports minimum_balance(uint64_t data_len) const {
-        return Lamports((account_storage_overhead + data_len) * lamports_per_byte_year() * exemption_threshold());
+        return exemption().minimum_balance(data_len);
     }
 };
 
@@ -166,6 +279,10 @@ inline void log(const Clock& clock) {
     );
 }
 
+inline LogWriter& operator<<(LogWriter& writer, const Clock& clock) {
+    return writer << "slot: " << clock.slot() << " epoch: " << clock.epoch() << " unix_timestamp: " << clock.unix_timestamp();
+}
+
 inline void log(const EpochSchedule& epoch_schedule) {
     syscall::sol_log_64_(
         epoch_schedule.slots_per_epoch(),
@@ -176,11 +293,16 @@ inline void log(const EpochSchedule& epoch_schedule) {
     );
 }
 
+inline LogWriter& operator<<(LogWriter& writer, const EpochSchedule& epoch_schedule) {
+    return writer << "slots_per_epoch: " << epoch_schedule.slots_per_epoch()
+                  << " first_normal_epoch: " << epoch_schedule.first_normal_epoch()
+                  << " first_normal_slot: " << epoch_schedule.first_normal_slot();
+}
+
 inline void log(const Rent& rent) {
-    double exemption_threshold = rent.exemption_threshold(); // reinterpreted as uint64_t for logging
     syscall::sol_log_64_(
         rent.lamports_per_byte_year(),
-        *reinterpret_cast<const uint64_t*>(&exemption_threshold),
+        __builtin_bit_cast(uint64_t, rent.exemption_threshold()), // the double's bits, for logging
         rent.burn_percent(),
         0,
         0
@@ -6,19 +6,32 @@
  */
 
 #include <sol_account.h>
+#include <sol_account_data.h>
+#include <sol_arena.h>
 #include <sol_base58.h>
+#include <sol_base64.h>
+#include <sol_borsh.h>
 #include <sol_bytes.h>
+#include <sol_entrypoint.h>
+#include <sol_event.h>
+#include <sol_hash.h>
+#include <sol_input.h>
 #include <sol_instruction.h>
 #include <sol_int.h>
+#include <sol_lamports.h>
 #include <sol_limits.h>
+#include <sol_log_line.h>
 #include <sol_logging.h>
 #include <sol_memory.h>
 #include <sol_native.h>
+#include <sol_pda.h>
 #include <sol_pubkey.h>
 #include <sol_seed.h>
+#include <sol_schema.h>
 #include <sol_serialization.h>
 #include <sol_status_codes.h>
 #include <sol_string.h>
 #include <sol_syscall_wrappers.h>
 #include <sol_syscalls.h>
+#include <sol_sysvar_cache.h>
 #include <sol_sysvars.h>
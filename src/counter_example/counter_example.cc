@@ -0,0 +1,72 @@
+/**
+ * Counting per authority, with instructions routed by a 1-byte tag
+ *
+ * This example shows how SOL_ENTRYPOINT generates the entrypoint from a list of handlers (see sol_entrypoint.h).
+ * The first byte of the instruction data selects the handler, whose parameters declare what it needs: the handlers below
+ * take the program id from the InstructionContext, their accounts as an Accounts<...> checked in a single pass, and
+ * increment() an amount decoded from the remaining instruction data.
+ *
+ * Instructions:
+ * 0. initialize: claims a zero-initialized account, owned by the program, as a counter of the signer
+ * 1. increment(u64 amount): adds the little-endian amount to the signer's counter and logs the new count
+ *
+ * Both take the same 2 accounts:
+ * 0. [SIGNER] The counter's authority
+ * 1. [WRITE] The counter, with at least AccountData<Counter>::SPACE bytes of data
+ */
+
+#include <solana_cpp_sdk.h>
+
+using namespace sol;
+
+// the data of a counter account, preceded by its discriminator
+struct Counter {
+    static constexpr uint64_t DISCRIMINATOR = account_discriminator("Counter");
+
+    Pubkey authority;  // the only signer who may increment the count
+    uint64_t count;
+};
+
+enum CounterError : uint32_t {
+    WRONG_AUTHORITY = 1,
+    COUNT_OVERFLOW,
+};
+
+using CounterAccounts = Accounts<
+    Signer,     // the authority
+    Writable<>  // the counter; its owner is checked when its data is loaded
+>;
+
+uint64_t initialize(const InstructionContext& context, CounterAccounts& accounts) {
+    AccountDataMut<Counter> counter;
+    if (const uint64_t error = counter.init(accounts.get<1>(), context.program_id)) {
+        log_error("ERROR: The counter is in use or too small");
+        return error;
+    }
+    counter->authority = accounts.get<0>().pubkey();
+    counter->count = 0;
+    return SUCCESS;
+}
+
+uint64_t increment(const InstructionContext& context, CounterAccounts& accounts, const uint64_t& amount) {
+    AccountDataMut<Counter> counter;
+    if (const uint64_t error = counter.load(accounts.get<1>(), context.program_id)) {
+        log_error("ERROR: Not a counter");
+        return error;
+    }
+    if (counter->authority != accounts.get<0>().pubkey()) {
+        return fail(WRONG_AUTHORITY, "ERROR: The signer is not the counter's authority");
+    }
+    uint64_t count = 0;
+    if (__builtin_add_overflow(counter->count, amount, &count)) {
+        return fail(COUNT_OVERFLOW, "ERROR: The count would overflow");
+    }
+    counter->count = count;
+    log_info("Count:", count);
+    return SUCCESS;
+}
+
+SOL_ENTRYPOINT(
+    Tag<0, initialize>,
+    Tag<1, increment>
+)
@@ -0,0 +1,77 @@
+/**
+ * Measures the compute units of memory operations, inline word loops versus the sol_mem*_ syscalls, by size
+ *
+ * Deploy the program and call it with at least one account, e.g. via `npm run account_logger_example <programId>`.
+ * Each measurement is logged as the remaining compute units before and after ITERATIONS operations.
+ * Subtracting the "empty loop" measurement and dividing by ITERATIONS yields the cost of a single operation. The size
+ * at which the syscall becomes cheaper is the crossover for SOL_MEM_INLINE_MAX (see sol_memory.h), and the same
+ * comparison for constant sizes is the crossover for SOL_MEM_UNROLL_MAX.
+ */
+
+#include <solana_cpp_sdk.h>
+
+using namespace sol;
+
+constexpr uint64_t ITERATIONS = 64;
+
+constexpr uint64_t SIZES[] = {8, 16, 24, 32, 48, 64, 96, 128, 256};
+
+// runs the operation ITERATIONS times on a length the compiler can't see
+template<class OPERATION>
+void measure(const char* name, uint64_t len, OPERATION operation) {
+    volatile uint64_t hidden_len = len;
+    log(name, len);
+    syscall::sol_log_compute_units_();
+    for (uint64_t i = 0; i != ITERATIONS; ++i) {
+        operation(hidden_len);
+    }
+    syscall::sol_log_compute_units_();
+}
+
+// runs the operation ITERATIONS times on a constant length
+template<uint64_t LEN, class OPERATION>
+void measure_constant(const char* name, OPERATION operation) {
+    log(name, LEN);
+    syscall::sol_log_compute_units_();
+    for (uint64_t i = 0; i != ITERATIONS; ++i) {
+        operation(LEN);
+    }
+    syscall::sol_log_compute_units_();
+}
+
+template<uint64_t... LENS>
+void measure_constants(uint8_t* dst, const uint8_t* src, internal::index_sequence<LENS...>) {
+    (measure_constant<SIZES[LENS]>("unrolled memcpy", [&](uint64_t len) { internal::copy_forward(dst, src, len); }), ...);
+}
+
+extern "C" uint64_t entrypoint(const uint8_t* input) {
+    InputView view(input);
+    if (view.accounts_given() < 1) {
+        return error::NOT_ENOUGH_ACCOUNT_KEYS;
+    }
+
+    // the pointers are opaque to the compiler, so that the loops aren't optimized away
+    alignas(8) uint8_t left[256] = {};
+    alignas(8) uint8_t right[256] = {};
+    uint8_t* volatile dst = left;
+    const uint8_t* volatile src = right;
+    int32_t differences = 0;
+
+    measure("empty loop", 0, [](uint64_t) {});
+    for (const uint64_t len : SIZES) {
+        measure("syscall memcpy", len, [&](uint64_t len) { syscall::sol_memcpy_(dst, src, len); });
+        measure("inline memcpy", len, [&](uint64_t len) { internal::copy_forward(dst, src, len); });
+        measure("syscall memset", len, [&](uint64_t len) { syscall::sol_memset_(dst, 0, len); });
+        measure("inline memset", len, [&](uint64_t len) { internal::fill(dst, 0, len); });
+        measure("syscall memcmp", len, [&](uint64_t len) {
+            int32_t result = 0;
+            syscall::sol_memcmp_(dst, src, len, &result);
+            differences += result;
+        });
+        measure("inline memcmp", len, [&](uint64_t len) { differences += internal::compare(dst, src, len); });
+    }
+    measure_constants(dst, src, internal::make_index_sequence<sizeof(SIZES) / sizeof(SIZES[0])>());
+
+    log("differences:", differences);
+    return SUCCESS;
+}
@@ -0,0 +1,79 @@
+/**
+ * Measures the compute units of Pubkey comparisons, byte by byte versus four 64-bit lanes
+ *
+ * Deploy the program and call it with at least one account, e.g. via `npm run account_logger_example <programId>`.
+ * Each measurement is logged as the remaining compute units before and after ITERATIONS comparisons.
+ * Subtracting the "empty loop" measurement and dividing by ITERATIONS yields the cost of a single comparison.
+ */
+
+#include <solana_cpp_sdk.h>
+
+using namespace sol;
+
+constexpr uint64_t ITERATIONS = 256;
+
+constexpr Pubkey CLOCK = sysvar::Clock::pubkey();
+
+// the implementations replaced by the lane-wise operators in sol_pubkey.h
+bool bytewise_equal(const Pubkey& left, const Pubkey& right) {
+    const uint8_t* l = reinterpret_cast<const uint8_t*>(&left);
+    const uint8_t* r = reinterpret_cast<const uint8_t*>(&right);
+    for (int i = 0; i != sizeof(Pubkey); ++i) {
+        if (l[i] != r[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool bytewise_less(const Pubkey& left, const Pubkey& right) {
+    const uint8_t* l = reinterpret_cast<const uint8_t*>(&left);
+    const uint8_t* r = reinterpret_cast<const uint8_t*>(&right);
+    for (int i = 0; i != sizeof(Pubkey); ++i) {
+        if (l[i] != r[i]) {
+            return l[i] < r[i];
+        }
+    }
+    return false;
+}
+
+// runs the comparison ITERATIONS times; the volatile pointers keep the compiler from hoisting it out of the loop
+template<class COMPARE>
+uint64_t measure(const char* name, const Pubkey* left, const Pubkey* right, COMPARE compare) {
+    const Pubkey* volatile l = left;
+    const Pubkey* volatile r = right;
+    uint64_t matches = 0;
+    log(name);
+    syscall::sol_log_compute_units_();
+    for (uint64_t i = 0; i != ITERATIONS; ++i) {
+        matches += compare(*l, *r);
+    }
+    syscall::sol_log_compute_units_();
+    return matches;
+}
+
+extern "C" uint64_t entrypoint(const uint8_t* input) {
+    InputView view(input);
+    if (view.accounts_given() < 1) {
+        return error::NOT_ENOUGH_ACCOUNT_KEYS;
+    }
+    const AccountView account = view.account(0);
+
+    // equal keys are the worst case for equality, as all 32 bytes must be compared
+    const Pubkey& key = account.pubkey();
+    Pubkey copy = key;
+
+    uint64_t matches = 0;
+    matches += measure("empty loop", &key, &copy, [](const Pubkey&, const Pubkey&) { return true; });
+    matches += measure("bytewise ==", &key, &copy, bytewise_equal);
+    matches += measure("lanes ==", &key, &copy, [](const Pubkey& l, const Pubkey& r) { return l == r; });
+    matches += measure("bytewise <", &key, &copy, bytewise_less);
+    matches += measure("lanes <", &key, &copy, [](const Pubkey& l, const Pubkey& r) { return l < r; });
+
+    // against a constant, the lanes become immediate operands
+    matches += measure("bytewise == constant", &key, &CLOCK, bytewise_equal);
+    matches += measure("lanes == constant", &key, &CLOCK, [](const Pubkey& l, const Pubkey&) { return l == CLOCK; });
+
+    log("matches:", matches);
+    return SUCCESS;
+}
@@ -5,9 +5,15 @@
  * Rather than using an explicit hash table, the username serves as the seed from which a program derived address (PDA) is created.
  * The program refuses the registration unless the so-derived account is owned by the System Program (i.e. not in use yet).
  * It then checks if the account is rent-exempt and assigns it to itself, storing the caller's public key in the account.
+ * The canonical bump seed is stored after the public key, so instructions operating on a registered account can check its address
+ * with verify_pda in a single hash. Registration itself must find the canonical bump seed, as any other would allow registering
+ * the same username at more than one address.
  * Finally, a cross-program invocation (CPI) is made to the Memo Program, described at https://spl.solana.com/memo, to ensure it is valid UTF-8.
  *
  * The program will log the PDA where the signer's pubkey is stored. The latter is logged via the Memo CPI.
+ * Failures are returned as the custom program errors of RegistryError. Build with -DSOL_LOG_LEVEL=SOL_LOG_LEVEL_NONE to leave
+ * out the messages accompanying them, which makes the program smaller and failures cheaper.
+ *
  * If you'd like to make sure the pubkey was stored correctly, send a getAccountInfo request for the PDA, asking for a base58 encoding:
  * https://docs.solana.com/developing/clients/jsonrpc-api#getaccountinfo
  */
@@ -16,96 +22,109 @@
 
 using namespace sol;
 
+struct MemoProgram {
+    static constexpr Pubkey pubkey() {
+        return from_base58("MemoSq4gqABAXKb96qnH8TysNcWxMyWCqXgDLGmfcHr");
+    }
+};
+
+// the data of a registered account
+struct Registration {
+    Pubkey user;        // who registered the username
+    uint8_t bump_seed;  // of the account's address
+};
+
+enum RegistryError : uint32_t {
+    WRONG_ADDRESS = 1,
+    NOT_RENT_EXEMPT,
+    ALLOCATE_FAILED,
+    ASSIGN_FAILED,
+    USERNAME_REJECTED,
+};
+
+using RegistrationAccounts = Accounts<
+    Signer,                                  // the user who's registering
+    Writable<Owner<native::SystemProgram>>,  // owned by the System Program, i.e. unused
+    Program<native::SystemProgram>,
+    Program<MemoProgram>
+>;
+
 uint64_t register_with_username(
     const Pubkey& program_id,
     const uint8_t* username,
     const uint64_t username_len,
     AccountInfo (&accounts)[4]
 ) {
-    const AccountInfo& signer = accounts[0];
-    AccountInfo& new_account = accounts[1];
-    const AccountInfo& system = accounts[2];
-    const AccountInfo& memo = accounts[3];
-
-    // check to see if the executables are the ones we expect
-    if (system.pubkey() != native::SystemProgram::pubkey()) {
-        log("ERROR: Expected System Program but got:", system.pubkey());
-        sol_panic();
-    }
-    if (memo.pubkey() != from_base58("MemoSq4gqABAXKb96qnH8TysNcWxMyWCqXgDLGmfcHr")) {
-        log("ERROR: Expected Memo Program but got:", memo.pubkey());
-        sol_panic();
-    }
-
-    // make sure the user actually signed
-    if (!signer.is_signer()) {
-        log("ERROR: Missing signature for account:", signer.pubkey());
-        sol_panic();
-    }
-
-    // this check ensures the account is unused
-    if (new_account.owner() != native::SystemProgram::pubkey()) {
-        log("ERROR: Account already in use:", new_account.pubkey());
-        sol_panic();
+    // check signature, ownership and the executables in a single pass
+    RegistrationAccounts checked;
+    const uint64_t error = checked.load(accounts, 4);
+    if (error != SUCCESS) {
+        log_error("ERROR: Unexpected accounts");
+        return error;
     }
+    const AccountInfo& signer = checked.get<0>();
+    AccountInfo& new_account = checked.get<1>();
+    const AccountInfo& system = checked.get<2>();
+    const AccountInfo& memo = checked.get<3>();
 
     // verify that the new account's address was derived with the username as seed
     FoundPDA pda = find_pda(program_id, SignerSeed(username, username_len));
-    log("PDA:", pda.pubkey, "bump seed:", pda.bump_seed);
+    log_info("PDA:", pda.pubkey, "bump seed:", pda.bump_seed);
     if (new_account.pubkey() != pda.pubkey) {
-        log("ERROR: Could not derive account address with the given username.");
-        sol_panic();
+        return fail(WRONG_ADDRESS, "ERROR: Could not derive account address with the given username.");
     }
 
     // check to see if it's rent-exempt
-    if (new_account.lamports() < sysvar::Rent().minimum_balance(sizeof(Pubkey))) {
-        log("ERROR: Account is not rent-exempt.");
-        sol_panic();
+    if (new_account.lamports() < minimum_balance(sizeof(Registration))) {
+        return fail(NOT_RENT_EXEMPT, "ERROR: Account is not rent-exempt.");
     }
 
-    // allocate space to store the signer's pubkey
-    AccountMeta allocate_metas[] = {{&new_account.pubkey(), true, true}};
-    native::SystemProgram::AllocateParams allocate_params(sizeof(Pubkey));
-    const Instruction allocate_instruction(system.pubkey(), allocate_metas, allocate_params);
+    // allocate space to store the registration
+    InstructionBuilder<1, sizeof(native::SystemProgram::AllocateParams)> allocate_instruction(system.pubkey());
+    allocate_instruction
+        .writable_signer(new_account.pubkey())
+        .data(native::SystemProgram::AllocateParams(sizeof(Registration)));
 
-    if (invoke_signed(allocate_instruction, accounts, {
+    if (invoke_signed_subset<1, 2>(allocate_instruction, accounts, {
         {{SignerSeed(username, username_len), SignerSeed(pda.bump_seed)}}
     }) != SUCCESS) {
-        log("ERROR: Could not allocate space.");
-        sol_panic();
+        return fail(ALLOCATE_FAILED, "ERROR: Could not allocate space.");
     }
 
     // assign the account to the program itself
-    AccountMeta assign_metas[] = {{&new_account.pubkey(), true, true}};
-    native::SystemProgram::AssignParams assign_params(program_id);
-    const Instruction assign_instruction(system.pubkey(), assign_metas, assign_params);
+    InstructionBuilder<1, sizeof(native::SystemProgram::AssignParams)> assign_instruction(system.pubkey());
+    assign_instruction
+        .writable_signer(new_account.pubkey())
+        .data(native::SystemProgram::AssignParams(program_id));
 
-    if (invoke_signed(assign_instruction, accounts, {
+    if (invoke_signed_subset<1, 2>(assign_instruction, accounts, {
         {{SignerSeed(username, username_len), SignerSeed(pda.bump_seed)}}
     }) != SUCCESS) {
-        log("ERROR: Could not take ownership of the account.");
-        sol_panic();
+        return fail(ASSIGN_FAILED, "ERROR: Could not take ownership of the account.");
     }
 
-    // copy the signer's pubkey to the account
-    memcpy(new_account.data(), &signer.pubkey(), sizeof(Pubkey));
+    // store the signer's pubkey and the bump seed in the account
+    Registration* registration = reinterpret_cast<Registration*>(new_account.data());
+    registration->user = signer.pubkey();
+    registration->bump_seed = pda.bump_seed;
 
     // let's make sure the username is valid UTF-8
     // since the C++ SDK doesn't provide any helpers for constructing Memo Program parameters, we have to do so manually
     // see https://docs.rs/spl-memo/3.0.1/src/spl_memo/lib.rs.html#30-39
-    AccountMeta memo_metas[] = {{&signer.pubkey(), false, true}};
-    const Instruction memo_instruction(memo.pubkey(), memo_metas, username, username_len);
+    InstructionBuilder<1, MAX_SEED_LEN> memo_instruction(memo.pubkey());
+    memo_instruction
+        .signer(signer.pubkey())
+        .bytes(username, username_len);
 
-    if (invoke(memo_instruction, accounts) != SUCCESS) {
-        log("ERROR: Username rejected. Is it valid UTF-8?");
-        sol_panic();
+    if (invoke_subset<0, 3>(memo_instruction, accounts) != SUCCESS) {
+        return fail(USERNAME_REJECTED, "ERROR: Username rejected. Is it valid UTF-8?");
     }
 
     return SUCCESS;
 }
 
 extern "C" uint64_t entrypoint(const uint8_t* input) {
-    log("C++ program entrypoint");
+    log_debug("C++ program entrypoint");
 
     // 4 accounts are required:
     // 0. [SIGNER] The user who's registering
@@ -0,0 +1,102 @@
+/**
+ * Depositing lamports into a vault and withdrawing them, with Anchor-compatible instructions
+ *
+ * This example shows how SOL_ENTRYPOINT routes instructions by the 8-byte sighash that Anchor clients send, i.e. the
+ * first 8 bytes of sha256("global:<name>") (see sol_entrypoint.h). The arguments following the sighash are decoded in
+ * the Borsh format, and the vault's data starts with Anchor's account discriminator, so an Anchor IDL describes the
+ * program as well.
+ *
+ * Instructions:
+ * - initialize: claims a zero-initialized account, owned by the program, as a vault of the signer
+ *   0. [SIGNER] The vault's authority
+ *   1. [WRITE] The vault, with at least AccountData<Vault>::SPACE bytes of data
+ * - deposit(u64 amount): moves lamports from a payer to the vault via the System Program
+ *   0. [SIGNER, WRITE] The payer
+ *   1. [WRITE] The vault
+ *   2. [] The System Program
+ * - withdraw(u64 amount): moves lamports from the vault to any account, keeping the vault rent-exempt
+ *   0. [SIGNER] The vault's authority
+ *   1. [WRITE] The vault
+ *   2. [WRITE] The recipient
+ *
+ * Withdrawals debit the vault in place, as the program owns it, rather than invoking the System Program (see sol_lamports.h).
+ */
+
+#include <solana_cpp_sdk.h>
+
+using namespace sol;
+
+// the data of a vault account, preceded by its discriminator
+struct Vault {
+    static constexpr uint64_t DISCRIMINATOR = account_discriminator("Vault");
+
+    Pubkey authority;  // the only signer who may withdraw
+};
+
+enum VaultError : uint32_t {
+    WRONG_AUTHORITY = 1,
+    NOT_RENT_EXEMPT,
+};
+
+uint64_t initialize(const InstructionContext& context, Accounts<Signer, Writable<>>& accounts) {
+    AccountDataMut<Vault> vault;
+    if (const uint64_t error = vault.init(accounts.get<1>(), context.program_id)) {
+        log_error("ERROR: The vault is in use or too small");
+        return error;
+    }
+    vault->authority = accounts.get<0>().pubkey();
+    return SUCCESS;
+}
+
+using DepositAccounts = Accounts<
+    Writable<Signer>,  // the payer
+    Writable<>,        // the vault
+    Program<native::SystemProgram>
+>;
+
+uint64_t deposit(const InstructionContext& context, DepositAccounts& accounts, const uint64_t& amount) {
+    AccountInfo& payer = accounts.get<0>();
+    AccountInfo& vault_account = accounts.get<1>();
+    AccountData<Vault> vault;
+    if (const uint64_t error = vault.load(vault_account, context.program_id)) {
+        log_error("ERROR: Not a vault");
+        return error;
+    }
+
+    // the payer is owned by the System Program, which thus has to debit it
+    InstructionBuilder<2, sizeof(native::SystemProgram::TransferParams)> transfer(native::SystemProgram::pubkey());
+    transfer
+        .writable_signer(payer.pubkey())
+        .writable(vault_account.pubkey())
+        .data(native::SystemProgram::TransferParams(Lamports(amount)));
+    return invoke(transfer, {payer, vault_account, accounts.get<2>()});
+}
+
+using WithdrawAccounts = Accounts<
+    Signer,      // the vault's authority
+    Writable<>,  // the vault
+    Writable<>   // the recipient
+>;
+
+uint64_t withdraw(const InstructionContext& context, WithdrawAccounts& accounts, const uint64_t& amount) {
+    AccountInfo& vault_account = accounts.get<1>();
+    AccountData<Vault> vault;
+    if (const uint64_t error = vault.load(vault_account, context.program_id)) {
+        log_error("ERROR: Not a vault");
+        return error;
+    }
+    if (vault->authority != accounts.get<0>().pubkey()) {
+        return fail(WRONG_AUTHORITY, "ERROR: The signer is not the vault's authority");
+    }
+    if (vault_account.lamports() < amount ||
+        vault_account.lamports() - amount < minimum_balance(vault_account.data_len())) {
+        return fail(NOT_RENT_EXEMPT, "ERROR: The vault would not remain rent-exempt");
+    }
+    return transfer_lamports(vault_account, accounts.get<2>(), amount);
+}
+
+SOL_ENTRYPOINT(
+    Sighash<instruction_discriminator("initialize"), initialize>,
+    Sighash<instruction_discriminator("deposit"), deposit>,
+    Sighash<instruction_discriminator("withdraw"), withdraw>
+)